@@ -28,6 +28,8 @@
  * or you may write to the Free Software Foundation, Inc.,
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
+#pragma once
+
 #include <stdint.h>
 
 
@@ -37,7 +39,7 @@ class ProgramCounter
 public:
 
 private:
-	uint16_t value;
+	uint16_t value = 0;
 	//Methods
 public:
 	ProgramCounter();
@@ -2,7 +2,7 @@
  *Class - RegisterFile
  *Author - Zach Walden
  *Created - 7/22/22
- *Last Changed - 10/13/23
+ *Last Changed - 10/19/26
  *Description - GameBoy Register File Implementation.
 ====================================================================================*/
 
@@ -252,6 +252,41 @@ bool RegisterFile::checkFlag(GbFlag::GbFlag flag)
 	return retVal;
 }
 
+void RegisterFile::saveState(SaveState* state)
+{
+	for(int i = 0; i < NUM_REG; i++)
+	{
+		state->write(this->regFile[i].readReg());
+	}
+	state->write(this->pc.read());
+	state->write(this->sp.read());
+}
+
+bool RegisterFile::loadState(SaveState* state)
+{
+	uint8_t value;
+	uint16_t pair;
+	for(int i = 0; i < NUM_REG; i++)
+	{
+		if(!state->read(value))
+		{
+			return false;
+		}
+		this->regFile[i].writeReg(value);
+	}
+	if(!state->read(pair))
+	{
+		return false;
+	}
+	this->pc.write(pair);
+	if(!state->read(pair))
+	{
+		return false;
+	}
+	this->sp.write(pair);
+	return true;
+}
+
 /*
 <++> RegisterFile::<++>()
 {
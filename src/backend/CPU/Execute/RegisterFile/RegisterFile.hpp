@@ -2,7 +2,7 @@
  *Class - RegisterFile
  *Author - Zach Walden
  *Created - 7/22/22
- *Last Changed - 10/17/23
+ *Last Changed - 10/19/26
  *Description - Register File, models gameboy. 8 registers A F, B C, D E, H L
  * 		Each 8-bit register may be paired with its
 ====================================================================================*/
@@ -37,6 +37,8 @@
 #include "stdint.h"
 #include <cstdint>
 
+#include "../../../SaveState/SaveState.hpp"
+
 #define NUM_REG 8
 
 namespace GbRegister
@@ -85,5 +87,8 @@ public:
 
 	void modifyFlag(GbFlag::GbFlag flag, bool newVal);
 	bool checkFlag(GbFlag::GbFlag flag);
+
+	void saveState(SaveState* state);
+	bool loadState(SaveState* state);
 private:
 };
@@ -38,7 +38,7 @@ class StackPointer
 public:
 
 private:
-	uint16_t value;
+	uint16_t value = 0;
 	//Methods
 public:
 	StackPointer();
@@ -2,7 +2,7 @@
  *Class - InterruptController
  *Author - Zach Walden
  *Created -
- *Last Changed -
+ *Last Changed - 10/19/26
  *Description -
 ====================================================================================*/
 
@@ -39,6 +39,8 @@ InterruptController::InterruptController(MMU* newMem, RegisterFile* regs, CycleL
 	this->mem = newMem;
 	this->regFile = regs;
 	this->listener = nListener;
+	this->mem->getIoRam()->registerHandler(io_reg::IF, nullptr, &InterruptController::writeInterruptReg, this);
+	this->mem->getIoRam()->registerHandler(IO_REG_IE_INDEX, nullptr, &InterruptController::writeInterruptReg, this);
 }
 InterruptController::~InterruptController()
 {
@@ -66,9 +68,12 @@ void InterruptController::getNextPC()
 		//handle interrupt
 		//reset ime flag
 		this->ime = false;
+		//The IF write below re-evaluates what is pending, take the vector being dispatched first.
+		uint16_t vector = this->isrAddr;
+		uint8_t ident = this->intIdent;
 		//reset IF flag for requested interrupt.
 		uint8_t ifr = this->mem->read(0xFF0F); //Read IF register
-		ifr = ifr & (~(this->intIdent));
+		ifr = ifr & (~ident);
 		this->mem->write(0xFF0F, ifr);
 		//Push PC to the stack
 		uint16_t curPc = this->regFile->readRegPair(GbRegister::GbRegister::PC);
@@ -77,7 +82,7 @@ void InterruptController::getNextPC()
 		this->mem->write(address - 2, curPc & 0x00FF);
 		this->regFile->decSp();
 		//change PC to ISR vector address;
-		this->regFile->writeRegPair(GbRegister::GbRegister::PC, this->isrAddr);
+		this->regFile->writeRegPair(GbRegister::GbRegister::PC, vector);
 		//TODO emit 5 M-Cycles
 	}
 }
@@ -87,6 +92,18 @@ void InterruptController::setIME(bool nextIme)
 	this->ime = nextIme;
 }
 
+void InterruptController::reset()
+{
+	this->ime = false;
+	this->nextIme = false;
+	this->imeChangePending = false;
+	this->imeCycleCount = 0;
+	this->isrAddr = 0x0000;
+	this->interruptPending = false;
+	this->intIdent = 0x00;
+	this->state = GbInt::GbState::NORMAL;
+}
+
 	//Execute Class will call this when it encounters a halt/stop instruciton.
 void InterruptController::processControlEvent(GbInt::GbEvent event)
 {
@@ -167,6 +184,42 @@ void InterruptController::handleInterrupts()
 		this->interruptPending = true;
 }
 
+void InterruptController::writeInterruptReg(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue)
+{
+	InterruptController* controller = (InterruptController*)instance;
+	controller->interruptPending = false;
+	controller->handleInterrupts();
+}
+
+void InterruptController::saveState(SaveState* state)
+{
+	state->write(this->ime);
+	state->write(this->nextIme);
+	state->write(this->imeChangePending);
+	state->write(this->imeCycleCount);
+	state->write(this->isrAddr);
+	state->write(this->interruptPending);
+	state->write(this->intIdent);
+	state->write((uint8_t)this->state);
+}
+
+bool InterruptController::loadState(SaveState* state)
+{
+	uint8_t intState;
+	bool ok = state->read(this->ime);
+	ok = ok && state->read(this->nextIme);
+	ok = ok && state->read(this->imeChangePending);
+	ok = ok && state->read(this->imeCycleCount);
+	ok = ok && state->read(this->isrAddr);
+	ok = ok && state->read(this->interruptPending);
+	ok = ok && state->read(this->intIdent);
+	ok = ok && state->read(intState);
+	if(ok)
+	{
+		this->state = (GbInt::GbState)intState;
+	}
+	return ok;
+}
 
 /*
 <++> InterruptController::<++>()
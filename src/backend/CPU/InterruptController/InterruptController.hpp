@@ -2,7 +2,7 @@
  *Class - InterruptController
  *Author - Zach Walden
  *Created - 2/19/24
- *Last Changed - 2/19/24
+ *Last Changed - 10/19/26
  *Description - Interrupt Controller, and State Controller
 ====================================================================================*/
 
@@ -29,9 +29,12 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#pragma once
+
 #include "../../CycleListener/CycleListener.hpp"
 #include "../Execute/RegisterFile/RegisterFile.hpp"
 #include "../MMU/MMU.hpp"
+#include "../../SaveState/SaveState.hpp"
 
 namespace GbInt
 {
@@ -74,7 +77,13 @@ public:
 	//Execute Class will call this when it encounters a halt/stop instruciton.
 	void processControlEvent(GbInt::GbEvent event);
 	void setIME(bool nextIME);
+	void reset();
+
+	void saveState(SaveState* state);
+	bool loadState(SaveState* state);
 private:
 	//this will be called each instruction cycle to check for interrupts.
 	void handleInterrupts();
+	//IF and IE write handler. The pending interrupt is worked out again from the new pair, a cleared request stops being pending.
+	static void writeInterruptReg(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue);
 };
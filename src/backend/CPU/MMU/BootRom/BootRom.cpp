@@ -2,7 +2,7 @@
  *Class - BootRom
  *Author - Zach Walden
  *Created - 7/25/22
- *Last Changed - 7/25/22
+ *Last Changed - 10/19/26
  *Description - Selects and Presents Correct Boot Rom based off the Presented Rom
 ====================================================================================*/
 
@@ -52,11 +52,96 @@ void BootRom::write(uint16_t address, uint8_t newValue)
 	this->dmgBootRom[localAddr] = newValue;
 }
 
+void BootRom::enableBootRom()
+{
+	this->enabled = true;
+}
+
 void BootRom::disableBootRom()
 {
 	this->enabled = false;
 }
 
+bool BootRom::isEnabled()
+{
+	return this->enabled;
+}
+
+void BootRom::writePostBootVram(const uint8_t* cartRom, uint8_t* vram)
+{
+	//Logo, 0x0104-0x0133. Each nibble has its bits doubled and is written to two rows of bitplane 0 from 0x8010.
+	uint16_t tile = 0x0010;
+	for(uint16_t i = 0x0104; i < 0x0134; i++)
+	{
+		uint8_t logo = (cartRom != nullptr) ? cartRom[i] : 0x00;
+		for(int shift = 4; shift >= 0; shift -= 4)
+		{
+			uint8_t nibble = (logo >> shift) & 0x0F;
+			uint8_t row = 0;
+			for(int bit = 3; bit >= 0; bit--)
+			{
+				row = (row << 2) | (((nibble >> bit) & 0x01) ? 0x03 : 0x00);
+			}
+			vram[tile] = row;
+			vram[tile + 2] = row;
+			tile += 4;
+		}
+	}
+	//The (R), copied from the boot rom's own 8 bytes at 0xD8, same stride.
+	for(int i = 0; i < 8; i++)
+	{
+		vram[tile + i * 2] = this->dmgBootRom[0xD8 + i];
+	}
+	//Tile map, (R) at 0x9910, logo tiles 1-12 at 0x9904 and 13-24 at 0x9924.
+	vram[0x1910] = 0x19;
+	for(int i = 0; i < 12; i++)
+	{
+		vram[0x1904 + i] = (uint8_t)(i + 1);
+		vram[0x1924 + i] = (uint8_t)(i + 13);
+	}
+}
+
+void BootRom::writePostBootStack(const uint8_t* cartRom, uint8_t* hram)
+{
+	//Stack left by the logo loop's last call to 0x0096, its return address and the BC it pushed (B = 1, C = last logo byte rotated left 7 times).
+	uint8_t last = (cartRom != nullptr) ? cartRom[0x0133] : 0x00;
+	hram[0xFA] = (uint8_t)((last << 7) | (last >> 1));
+	hram[0xFB] = 0x01;
+	hram[0xFC] = 0x2E;
+	hram[0xFD] = 0x00;
+}
+
+uint16_t BootRom::getPostBootAF(const uint8_t* cartRom)
+{
+	//A = 0x19 + 0x0134..0x014C, then one last add of the checksum byte. Only the flags survive, A is reloaded with 1.
+	uint8_t sum = 0x19;
+	uint8_t checksum = 0x00;
+	if(cartRom != nullptr)
+	{
+		for(uint16_t i = 0x0134; i < 0x014D; i++)
+		{
+			sum += cartRom[i];
+		}
+		checksum = cartRom[0x014D];
+	}
+	uint8_t result = sum + checksum;
+	uint8_t flags = 0x00;
+	flags |= (result == 0) ? 0x80 : 0x00;
+	flags |= (((sum & 0x0F) + (checksum & 0x0F)) > 0x0F) ? 0x20 : 0x00;
+	flags |= (((uint16_t)sum + checksum) > 0xFF) ? 0x10 : 0x00;
+	return 0x0100 | flags;
+}
+
+void BootRom::saveState(SaveState* state)
+{
+	state->write(this->enabled);
+}
+
+bool BootRom::loadState(SaveState* state)
+{
+	return state->read(this->enabled);
+}
+
 /*
 <++> BootRom::<++>()
 {
@@ -2,7 +2,7 @@
  *Class - BootRom
  *Author - Zach Walden
  *Created - 7/25/22
- *Last Changed - 7/25/22
+ *Last Changed - 10/19/26
  *Description - Selects and Presents Correct Boot Rom based off the Presented Rom
 ====================================================================================*/
 
@@ -30,11 +30,15 @@
  */
 
 #define DMG_BOOT_ROM_SIZE 256
+//Where the boot rom hands over to the cartridge.
+#define POST_BOOT_PC 0x0100
 
 #pragma once
 
 #include "stdint.h"
 
+#include "../../../SaveState/SaveState.hpp"
+
 class BootRom
 {
 	//Attributes
@@ -69,6 +73,17 @@ public:
 	uint8_t read(uint16_t address);
 	void write(uint16_t address, uint8_t newValue);
 
+	void enableBootRom();
 	void disableBootRom();
+	bool isEnabled();
+
+	//What the boot rom leaves behind, for fast boot. cartRom may be nullptr (no cart), the logo then reads as zeros.
+	void writePostBootVram(const uint8_t* cartRom, uint8_t* vram);
+	void writePostBootStack(const uint8_t* cartRom, uint8_t* hram);
+	//AF after the header checksum loop, the flags come from its final add.
+	uint16_t getPostBootAF(const uint8_t* cartRom);
+
+	void saveState(SaveState* state);
+	bool loadState(SaveState* state);
 private:
 };
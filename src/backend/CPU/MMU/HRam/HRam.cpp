@@ -1,9 +1,9 @@
 /*==================================================================================
  *Class - HRam
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - HRam 0xFF80 -> 0xFFFF
 ====================================================================================*/
 
 /*
@@ -33,6 +33,16 @@
 
 #include "HRam.hpp"
 
+HRam::HRam()
+{
+
+}
+
+HRam::~HRam()
+{
+
+}
+
 uint8_t HRam::read(uint8_t address)
 {
 	return this->hram[address];
@@ -43,6 +53,17 @@ void HRam::write(uint8_t address, uint8_t value)
 	this->hram[address] = value;
 }
 
+void HRam::attach(uint8_t* memory)
+{
+	this->hram = memory;
+}
+
+uint8_t* HRam::getData()
+{
+	return this->hram;
+}
+
+
 /*
 <++> HRam::<++>()
 {
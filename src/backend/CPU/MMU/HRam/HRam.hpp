@@ -2,7 +2,7 @@
  *Class - HRam
  *Author - Zach Walden
  *Created - 2/19/24
- *Last Changed - 2/19/24
+ *Last Changed - 10/19/26
  *Description - HRam 0xFF80 -> 0xFFFF
 ====================================================================================*/
 
@@ -29,6 +29,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#pragma once
+
 #include <cstdint>
 
 #define HRAM_SIZE 256
@@ -39,7 +41,7 @@ class HRam
 public:
 
 private:
-	uint8_t hram[HRAM_SIZE];
+	uint8_t* hram = nullptr;
 	//Methods
 public:
 	HRam();
@@ -47,5 +49,9 @@ public:
 
 	uint8_t read(uint8_t address);
 	void write(uint8_t address, uint8_t value);
+
+	//Points the memory at its region of the arena, HRAM_SIZE bytes.
+	void attach(uint8_t* memory);
+	uint8_t* getData();
 private:
 };
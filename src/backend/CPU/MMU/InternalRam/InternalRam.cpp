@@ -1,9 +1,9 @@
 /*==================================================================================
  *Class - InternalRam
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Work Ram 0xC000 -> 0xDFFF, echoed at 0xE000 -> 0xFDFF
 ====================================================================================*/
 
 /*
@@ -33,22 +33,35 @@
 
 #include "InternalRam.hpp"
 
+InternalRam::InternalRam()
+{
 
+}
 
+InternalRam::~InternalRam()
+{
 
+}
 
+uint8_t InternalRam::read(uint16_t address)
+{
+	return this->ram[address & 0x1FFF];
+}
 
+void InternalRam::write(uint16_t address, uint8_t value)
+{
+	this->ram[address & 0x1FFF] = value;
+}
 
+void InternalRam::attach(uint8_t* memory)
+{
+	this->ram = memory;
+}
 
-
-
-
-
-
-
-
-
-
+uint8_t* InternalRam::getData()
+{
+	return this->ram;
+}
 
 
 /*
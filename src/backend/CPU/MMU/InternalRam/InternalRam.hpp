@@ -1,9 +1,9 @@
 /*==================================================================================
  *Class - InternalRam
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Work Ram 0xC000 -> 0xDFFF, echoed at 0xE000 -> 0xFDFF
 ====================================================================================*/
 
 /*
@@ -29,7 +29,11 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#pragma once
 
+#include <cstdint>
+
+#define INTERNAL_RAM_SIZE 8192
 
 class InternalRam
 {
@@ -37,10 +41,18 @@ class InternalRam
 public:
 
 private:
+	//Lives in the GameBoy's MemoryArena.
+	uint8_t* ram = nullptr;
 	//Methods
 public:
 	InternalRam();
 	~InternalRam();
 
+	uint8_t read(uint16_t address);
+	void write(uint16_t address, uint8_t value);
+
+	//Points the memory at its region of the arena, INTERNAL_RAM_SIZE bytes.
+	void attach(uint8_t* memory);
+	uint8_t* getData();
 private:
 };
@@ -2,7 +2,7 @@
  *Class - MMU
  *Author - Zach Walden
  *Created - 7/22/22
- *Last Changed - 7/22/22
+ *Last Changed - 10/19/26
  *Description - Memory Management Unit. This unit hanldes all mapping of memory.
 ====================================================================================*/
 
@@ -31,6 +31,8 @@
 
 #pragma once
 
+#include <cstring>
+
 #include "MMU.hpp"
 
 
@@ -39,178 +41,433 @@ MMU::MMU(Cartridge* cart, VRAM* vram, IoRam* ioRam, OamRam* oamRam)
 	this->cart = cart;
 	this->vram = vram;
 	this->ioRam = ioRam;
+	this->oamRam = oamRam;
+	this->ioRam->registerHandler(io_reg::DMA, nullptr, &MMU::writeDma, this);
+	this->ioRam->registerHandler(io_reg::DBOOTR, nullptr, &MMU::writeBootRomDisable, this);
+	for(int i = 0; i < MMU_PAGE_COUNT; i++)
+	{
+		this->readMap[i] = nullptr;
+		this->writeMap[i] = nullptr;
+		this->readWatchCount[i] = 0;
+		this->writeWatchCount[i] = 0;
+	}
 }
 MMU::~MMU()
 {
 
 }
 uint8_t MMU::read(uint16_t address)
+{
+	//Banked or not, a mapped page is one load.
+	const uint8_t* page = this->readMap[address >> MMU_PAGE_SHIFT];
+	if(page != nullptr)
+	{
+		return page[address & (MMU_PAGE_SIZE - 1)];
+	}
+	if(this->readWatchCount[address >> MMU_PAGE_SHIFT] != 0)
+	{
+		return this->readWatched(address);
+	}
+	//Page 0xFF is hit constantly (IO, HRAM, IE), skip the decoder for it.
+	if(address >= this->ioRamStart)
+	{
+		return (address >= this->hRamStart && address <= this->hRamEnd) ? this->hRam.read(address) : this->ioRam->read(address);
+	}
+	//Every page is off the map during a DMA, so this is the only place that has to check for it.
+	if(this->dmaActive && this->isBusLocked(address))
+	{
+		return 0xFF;
+	}
+	return this->readSlow(address);
+}
+void MMU::write(uint16_t address, uint8_t newValue)
+{
+	uint8_t* page = this->writeMap[address >> MMU_PAGE_SHIFT];
+	if(page != nullptr)
+	{
+		page[address & (MMU_PAGE_SIZE - 1)] = newValue;
+		return;
+	}
+	if(this->writeWatchCount[address >> MMU_PAGE_SHIFT] != 0)
+	{
+		this->writeWatched(address, newValue);
+		return;
+	}
+	if(address >= this->ioRamStart)
+	{
+		if(address >= this->hRamStart && address <= this->hRamEnd)
+		{
+			this->hRam.write(address, newValue);
+		}
+		else
+		{
+			this->ioRam->write(address, newValue);
+		}
+		return;
+	}
+	if(this->dmaActive && this->isBusLocked(address))
+	{
+		return;
+	}
+	this->writeSlow(address, newValue);
+}
+void MMU::readBlock(uint16_t address, uint8_t* out, size_t length, bool peek)
+{
+	while(length > 0)
+	{
+		size_t run = this->mappedRun(this->readMap, address, length);
+		if(run > 0)
+		{
+			memcpy(out, this->readMap[address >> MMU_PAGE_SHIFT] + (address & (MMU_PAGE_SIZE - 1)), run);
+		}
+		else
+		{
+			*out = peek ? this->peekSlow(address) : this->read(address);
+			run = 1;
+		}
+		out += run;
+		length -= run;
+		address += run;
+	}
+}
+void MMU::writeBlock(uint16_t address, const uint8_t* data, size_t length, bool peek)
+{
+	while(length > 0)
+	{
+		//Looked up again every run, a write through the slow path may have moved a bank.
+		size_t run = this->mappedRun((const uint8_t* const*)this->writeMap, address, length);
+		if(run > 0)
+		{
+			memcpy(this->writeMap[address >> MMU_PAGE_SHIFT] + (address & (MMU_PAGE_SIZE - 1)), data, run);
+		}
+		else
+		{
+			if(peek)
+			{
+				this->pokeSlow(address, *data);
+			}
+			else
+			{
+				this->write(address, *data);
+			}
+			run = 1;
+		}
+		data += run;
+		length -= run;
+		address += run;
+	}
+}
+int MMU::addWatchpoint(uint16_t startAddress, uint16_t endAddress, uint8_t type, void (*callback)(void*, uint16_t, uint8_t, bool), void* instance)
+{
+	if(startAddress > endAddress)
+	{
+		return -1;
+	}
+	Watchpoint watch = { this->nextWatchId, startAddress, endAddress, type, callback, instance };
+	for(int page = startAddress >> MMU_PAGE_SHIFT; page <= (endAddress >> MMU_PAGE_SHIFT); page++)
+	{
+		if(this->readWatchCount[page] == 0xFF || this->writeWatchCount[page] == 0xFF)
+		{
+			return -1;
+		}
+	}
+	this->nextWatchId++;
+	this->watchpoints.push_back(watch);
+	this->countWatch(&watch, 1);
+	this->remap();
+	return watch.id;
+}
+bool MMU::removeWatchpoint(int id)
+{
+	for(size_t i = 0; i < this->watchpoints.size(); i++)
+	{
+		if(this->watchpoints[i].id == id)
+		{
+			this->countWatch(&this->watchpoints[i], -1);
+			this->watchpoints.erase(this->watchpoints.begin() + i);
+			this->remap();
+			return true;
+		}
+	}
+	return false;
+}
+void MMU::clearWatchpoints()
+{
+	this->watchpoints.clear();
+	for(int i = 0; i < MMU_PAGE_COUNT; i++)
+	{
+		this->readWatchCount[i] = 0;
+		this->writeWatchCount[i] = 0;
+	}
+	this->remap();
+}
+void MMU::countWatch(Watchpoint* watch, int delta)
+{
+	for(int page = watch->startAddress >> MMU_PAGE_SHIFT; page <= (watch->endAddress >> MMU_PAGE_SHIFT); page++)
+	{
+		if((watch->type & GbWatch::READ) != 0)
+		{
+			this->readWatchCount[page] += delta;
+		}
+		if((watch->type & GbWatch::WRITE) != 0)
+		{
+			this->writeWatchCount[page] += delta;
+		}
+	}
+}
+uint8_t MMU::readWatched(uint16_t address)
+{
+	uint8_t value = this->isBusLocked(address) ? 0xFF : this->readSlow(address);
+	for(size_t i = 0; i < this->watchpoints.size(); i++)
+	{
+		Watchpoint& watch = this->watchpoints[i];
+		if((watch.type & GbWatch::READ) != 0 && address >= watch.startAddress && address <= watch.endAddress)
+		{
+			watch.callback(watch.instance, address, value, false);
+		}
+	}
+	return value;
+}
+void MMU::writeWatched(uint16_t address, uint8_t newValue)
+{
+	if(this->isBusLocked(address))
+	{
+		return;
+	}
+	this->writeSlow(address, newValue);
+	for(size_t i = 0; i < this->watchpoints.size(); i++)
+	{
+		Watchpoint& watch = this->watchpoints[i];
+		if((watch.type & GbWatch::WRITE) != 0 && address >= watch.startAddress && address <= watch.endAddress)
+		{
+			watch.callback(watch.instance, address, newValue, true);
+		}
+	}
+}
+size_t MMU::mappedRun(const uint8_t* const* map, uint16_t address, size_t length)
+{
+	uint32_t page = address >> MMU_PAGE_SHIFT;
+	const uint8_t* base = map[page];
+	if(base == nullptr)
+	{
+		return 0;
+	}
+	size_t run = MMU_PAGE_SIZE - (address & (MMU_PAGE_SIZE - 1));
+	//Stop at the top of the address space so the caller wraps through the map again.
+	for(page++; run < length && page < MMU_PAGE_COUNT && map[page] == base + (run + (address & (MMU_PAGE_SIZE - 1))); page++)
+	{
+		run += MMU_PAGE_SIZE;
+	}
+	return (run < length) ? run : length;
+}
+uint8_t MMU::peekSlow(uint16_t address)
+{
+	GbMem::MemUnit memUnit = this->decodeAddress(address);
+	if(memUnit == GbMem::IO_RAM || memUnit == GbMem::INT_REG)
+	{
+		return this->ioRam->peek(address);
+	}
+	//Everything else off the page map reads without side effects.
+	return this->readSlow(address);
+}
+void MMU::pokeSlow(uint16_t address, uint8_t newValue)
+{
+	GbMem::MemUnit memUnit = this->decodeAddress(address);
+	if(memUnit == GbMem::IO_RAM || memUnit == GbMem::INT_REG)
+	{
+		this->ioRam->poke(address, newValue);
+	}
+	else if(address > this->cartBank1End && memUnit != GbMem::BOOT_ROM)
+	{
+		//Below 0x8000 a write is a bank controller command, never data.
+		this->writeSlow(address, newValue);
+	}
+}
+uint8_t MMU::readSlow(uint16_t address)
 {
 	uint8_t retVal = 0;
 	//Decode what location in memory the address points to.
-	MemUnit memUnit = this->decodeAddress(address);
+	GbMem::MemUnit memUnit = this->decodeAddress(address);
 	//Choose which read function to call
 	switch(memUnit)
 	{
-		case VRAM :
+		case GbMem::VRAM :
 		{
 			retVal = this->readVram(address);
 			break;
 		}
-		case CART :
+		case GbMem::CART :
 		{
 			retVal = this->readCartridge(address);
 			break;
 		}
-		case OAM :
+		case GbMem::OAM :
 		{
 			retVal = this->readOamRam(address);
 			break;
 		}
-		case IO_RAM :
+		case GbMem::IO_RAM :
 		{
 			retVal = this->readIoRam(address);
 			break;
 		}
-		case INT_RAM :
+		case GbMem::INT_RAM :
 		{
 			retVal = this->internalRam.read(address);
 			break;
 		}
-		case INT_RAM_ECHO :
+		case GbMem::INT_RAM_ECHO :
 		{
 			address = address - (uint16_t)0x2000;
 			retVal = this->internalRam.read(address);
 			break;
 		}
-		case BOOT_ROM :
+		case GbMem::BOOT_ROM :
 		{
 			retVal = this->bootRom.read(address);
 			break;
 		}
-		case HRAM :
+		case GbMem::HRAM :
 		{
 			retVal = this->hRam.read(address);
 			break;
 		}
-		case NONE :
+		case GbMem::INT_REG :
 		{
+			retVal = this->readIoRam(address);
 			break;
 		}
-		case default :
+		case GbMem::NONE :
+		{
+			retVal = 0xFF;
+			break;
+		}
+		default :
 		{
 			break;
 		}
 	}
+	return retVal;
 }
-void MMU::write(uint16_t address, uint8_t newValue)
+void MMU::writeSlow(uint16_t address, uint8_t newValue)
 {
 	//Decode what location in memory the address points to.
-	MemUnit memUnit = this->decodeAddress(address);
+	GbMem::MemUnit memUnit = this->decodeAddress(address);
 	//Choose which read function to call
 	switch(memUnit)
 	{
-		case VRAM :
+		case GbMem::VRAM :
 		{
 			this->writeVram(address, newValue);
 			break;
 		}
-		case CART :
+		case GbMem::CART :
 		{
 			this->writeCartridge(address, newValue);
 			break;
 		}
-		case OAM :
+		case GbMem::OAM :
 		{
 			this->writeOamRam(address, newValue);
 			break;
 		}
-		case IO_RAM :
+		case GbMem::IO_RAM :
 		{
 			this->writeIoRam(address, newValue);
 			break;
 		}
-		case INT_RAM :
+		case GbMem::INT_RAM :
 		{
 			this->internalRam.write(address, newValue);
 			break;
 		}
-		case INT_RAM_ECHO :
+		case GbMem::INT_RAM_ECHO :
 		{
 			address = address - (uint16_t)0x2000;
 			this->internalRam.write(address, newValue);
 			break;
 		}
-		case BOOT_ROM :
+		case GbMem::BOOT_ROM :
 		{
+			//The boot rom only overlays reads, the cart still sees the write.
+			this->writeCartridge(address, newValue);
 			break;
 		}
-		case HRAM :
+		case GbMem::HRAM :
 		{
 			this->hRam.write(address, newValue);
 			break;
 		}
-		case NONE :
+		case GbMem::INT_REG :
+		{
+			this->writeIoRam(address, newValue);
+			break;
+		}
+		case GbMem::NONE :
 		{
 			break;
 		}
-		case default :
+		default :
 		{
 			break;
 		}
 	}
 }
 
-MemUnit MMU::decodeAddress(uint16_t address)
+GbMem::MemUnit MMU::decodeAddress(uint16_t address)
 {
-	MemUnit retVal = NONE;
+	GbMem::MemUnit retVal = GbMem::NONE;
 	if(address >= 0x0000 && address < 0x0100)
 	{
 		//Check if bootRom is enabled
-		if()
+		if(this->bootRom.isEnabled())
 		{
-			retVal = BOOT_ROM;
+			retVal = GbMem::BOOT_ROM;
 		}
 		else
 		{
-			retVal = CART;
+			retVal = GbMem::CART;
 		}
 	}
 	else if(address <= this->cartBank1End)
 	{
-		retVal = CART;
+		retVal = GbMem::CART;
 	}
 	else if(address <= this->vRamEnd)
 	{
-		retVal = VRAM;
+		retVal = GbMem::VRAM;
+	}
+	else if(address <= this->exRamEnd)
+	{
+		retVal = GbMem::CART;
 	}
 	else if(address <= this->ramEnd)
 	{
-		retVal = INT_RAM;
+		retVal = GbMem::INT_RAM;
 	}
 	else if(address < this->oamRamStart)
 	{
-		retVal = INT_RAM_ECHO;
+		retVal = GbMem::INT_RAM_ECHO;
 	}
 	else if(address <= this->oamRamEnd)
 	{
-		retVal = OAM;
+		retVal = GbMem::OAM;
 	}
 	else if(address < this->ioRamStart)
 	{
-		retVal = NONE;
+		retVal = GbMem::NONE;
 	}
 	else if(address <= this->ioRamEnd)
 	{
-		retVal = IO_RAM;
+		retVal = GbMem::IO_RAM;
 	}
 	else if(address <= this->hRamEnd)
 	{
-		retVal = HRAM;
+		retVal = GbMem::HRAM;
 	}
 	else
 	{
-		retVal = INT_REG;
+		retVal = GbMem::INT_REG;
 	}
 
 	return retVal;
@@ -233,7 +490,7 @@ void MMU::writeVram(uint16_t address, uint8_t newValue)
 }
 uint8_t MMU::readIoRam(uint16_t address)
 {
-	return this->ioRam(address);
+	return this->ioRam->read(address);
 }
 void MMU::writeIoRam(uint16_t address, uint8_t newValue)
 {
@@ -245,7 +502,228 @@ uint8_t MMU::readCartridge(uint16_t address)
 }
 void MMU::writeCartridge(uint16_t address, uint8_t newValue)
 {
-	this->cart->write(address, newValue);
+	if(this->cart->write(address, newValue))
+	{
+		this->remapCartridge(false);
+	}
+}
+void MMU::writeDma(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue)
+{
+	MMU* mmu = (MMU*)instance;
+	//0xXX00-0xXX9F into OAM in one go. Sources past WRAM read the echo, as the DMG's DMA does.
+	uint16_t source = (uint16_t)newValue << 8;
+	if(source >= 0xE000)
+	{
+		source -= 0x2000;
+	}
+	mmu->readBlock(source, mmu->oamRam->getData(), OAM_RAM_SIZE, true);
+	//The copy skipped OamRam::write, the sprite lines are rebuilt in one pass instead of 160 updates.
+	mmu->oamRam->rebuildLines();
+	if(mmu->clock == nullptr)
+	{
+		return;
+	}
+	//A restart mid transfer just pushes the end out.
+	mmu->dmaEndCycle = *mmu->clock + OAM_DMA_CYCLES;
+	if(!mmu->dmaActive)
+	{
+		//Nothing is mapped until the DMA ends, finishDma rebuilds the map.
+		mmu->dmaActive = true;
+		memset(mmu->readMap, 0, sizeof(mmu->readMap));
+		memset(mmu->writeMap, 0, sizeof(mmu->writeMap));
+	}
+}
+bool MMU::isBusLocked(uint16_t address)
+{
+	if(!this->dmaActive || address >= this->ioRamStart)
+	{
+		return false;
+	}
+	if(*this->clock >= this->dmaEndCycle)
+	{
+		this->finishDma();
+		return false;
+	}
+	return true;
+}
+void MMU::finishDma()
+{
+	this->dmaActive = false;
+	this->remap();
+}
+void MMU::tick()
+{
+	if(this->dmaActive && *this->clock >= this->dmaEndCycle)
+	{
+		this->finishDma();
+	}
+}
+bool MMU::isDmaActive()
+{
+	return this->dmaActive;
+}
+void MMU::attachClock(const uint64_t* clock)
+{
+	this->clock = clock;
+}
+void MMU::writeBootRomDisable(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue)
+{
+	MMU* mmu = (MMU*)instance;
+	//One way, only a reset maps the boot rom back in.
+	if(newValue != 0 && mmu->bootRom.isEnabled())
+	{
+		mmu->bootRom.disableBootRom();
+		mmu->remapCartridge(true);
+	}
+}
+
+void MMU::reset()
+{
+	this->dmaActive = false;
+	this->bootRom.enableBootRom();
+	this->cart->reset();
+	this->remap();
+}
+void MMU::fastBoot()
+{
+	const uint8_t* rom = this->cart->getRom();
+	//Register writes in the order the boot rom makes them, so the handlers see the same sequence.
+	this->ioRam->write(0xFF26, 0x80);
+	this->ioRam->write(0xFF11, 0x80);
+	this->ioRam->write(0xFF12, 0xF3);
+	this->ioRam->write(0xFF25, 0xF3);
+	this->ioRam->write(0xFF24, 0x77);
+	this->ioRam->write(0xFF47, 0xFC);
+	this->bootRom.writePostBootVram(rom, this->vram->getData());
+	this->vram->markAllDirty();
+	this->ioRam->write(0xFF42, 0x00);
+	this->ioRam->write(0xFF40, 0x91);
+	//Second note of the chime.
+	this->ioRam->write(0xFF13, 0xC1);
+	this->ioRam->write(0xFF14, 0x87);
+	this->bootRom.writePostBootStack(rom, this->hRam.getData());
+	//What the timer, PPU and APU have produced by the end of the animation (Pan Docs), they don't run during a fast boot.
+	uint8_t* regs = this->ioRam->getData();
+	regs[io_reg::DIV] = 0xAB;
+	regs[io_reg::IF] = 0x01;
+	regs[io_reg::STAT] = 0x05;
+	regs[io_reg::LY] = 0x00;
+	regs[io_reg::NR52] = 0x81;
+	this->ioRam->write(0xFF50, 0x01);
+}
+bool MMU::isBootRomMapped()
+{
+	return this->bootRom.isEnabled();
+}
+uint16_t MMU::getPostBootAF()
+{
+	return this->bootRom.getPostBootAF(this->cart->getRom());
+}
+void MMU::remap()
+{
+	for(int i = 0; i < MMU_PAGE_COUNT; i++)
+	{
+		this->readMap[i] = nullptr;
+		this->writeMap[i] = nullptr;
+	}
+	uint8_t* wram = this->internalRam.getData();
+	uint8_t* vramData = this->vram->getData();
+	//Tile data writes go through VRAM::write so the tile cache hears about them, the maps are plain memory.
+	this->mapPages(this->vRamStart, this->vRamStart + VRAM_TILE_DATA_SIZE - 1, vramData, nullptr);
+	this->mapPages(this->vRamStart + VRAM_TILE_DATA_SIZE, this->vRamEnd, vramData + VRAM_TILE_DATA_SIZE, vramData + VRAM_TILE_DATA_SIZE);
+	this->mapPages(this->ramStart, this->ramEnd, wram, wram);
+	//Echo stops short of OAM, 0xFE00 stays on the slow path.
+	this->mapPages(0xE000, this->oamRamStart - 1, wram, wram);
+	this->remapCartridge(true);
+}
+void MMU::remapCartridge(bool force)
+{
+	//Rom windows are read only, writes always go through the controller.
+	const uint8_t* bank0 = this->cart->getRomWindow(this->cartBank0Start);
+	const uint8_t* bank1 = this->cart->getRomWindow(this->cartBank1Start);
+	const uint8_t* ram = this->cart->getRamWindow();
+	uint8_t* ramWrite = this->cart->getRamWriteWindow();
+	if(force || bank0 != this->bank0Window)
+	{
+		this->mapPages(this->cartBank0Start, this->cartBank0End, bank0, nullptr);
+		if(this->bootRom.isEnabled())
+		{
+			this->readMap[0] = nullptr;
+		}
+		this->bank0Window = bank0;
+	}
+	if(force || bank1 != this->bank1Window)
+	{
+		this->mapPages(this->cartBank1Start, this->cartBank1End, bank1, nullptr);
+		this->bank1Window = bank1;
+	}
+	if(force || ram != this->exRamWindow || ramWrite != this->exRamWriteWindow)
+	{
+		this->mapPages(this->exRamStart, this->exRamEnd, ram, ramWrite);
+		this->exRamWindow = ram;
+		this->exRamWriteWindow = ramWrite;
+	}
+}
+void MMU::mapPages(uint16_t startAddress, uint16_t endAddress, const uint8_t* readBase, uint8_t* writeBase)
+{
+	int first = startAddress >> MMU_PAGE_SHIFT;
+	int count = (endAddress >> MMU_PAGE_SHIFT) - first + 1;
+	for(int i = 0; i < count; i++)
+	{
+		this->readMap[first + i] = (readBase != nullptr) ? readBase + (i << MMU_PAGE_SHIFT) : nullptr;
+	}
+	for(int i = 0; i < count; i++)
+	{
+		this->writeMap[first + i] = (writeBase != nullptr) ? writeBase + (i << MMU_PAGE_SHIFT) : nullptr;
+	}
+	//Watched pages stay off the map whatever is banked in, so their accesses reach the watch check.
+	for(int i = first; i < first + count; i++)
+	{
+		if(this->readWatchCount[i] != 0)
+		{
+			this->readMap[i] = nullptr;
+		}
+		if(this->writeWatchCount[i] != 0)
+		{
+			this->writeMap[i] = nullptr;
+		}
+		//Nothing is mapped while a DMA holds the bus, every access has to see the lock.
+		if(this->dmaActive)
+		{
+			this->readMap[i] = nullptr;
+			this->writeMap[i] = nullptr;
+		}
+	}
+}
+InternalRam* MMU::getInternalRam()
+{
+	return &this->internalRam;
+}
+HRam* MMU::getHRam()
+{
+	return &this->hRam;
+}
+IoRam* MMU::getIoRam()
+{
+	return this->ioRam;
+}
+
+void MMU::saveState(SaveState* state)
+{
+	this->bootRom.saveState(state);
+	this->cart->saveState(state);
+	state->write(this->dmaActive);
+	state->write(this->dmaEndCycle);
+}
+bool MMU::loadState(SaveState* state)
+{
+	bool ok = this->bootRom.loadState(state);
+	ok = ok && this->cart->loadState(state);
+	ok = ok && state->read(this->dmaActive);
+	ok = ok && state->read(this->dmaEndCycle);
+	this->dmaActive = ok && this->dmaActive && this->clock != nullptr;
+	this->remap();
+	return ok;
 }
 
 /*
@@ -2,7 +2,7 @@
  *Class - MMU
  *Author - Zach Walden
  *Created - 7/22/22
- *Last Changed - 7/22/22
+ *Last Changed - 10/19/26
  *Description - Memory Management Unit. This unit hanldes all mapping of memory.
 ====================================================================================*/
 
@@ -32,6 +32,8 @@
 #pragma once
 
 #include "stdint.h"
+#include <cstddef>
+#include <vector>
 
 #include "../../PPU/VRAM/VRAM.hpp"
 #include "../../Cartridge/Cartridge.hpp"
@@ -40,11 +42,41 @@
 #include "BootRom/BootRom.hpp"
 #include "InternalRam/InternalRam.hpp"
 #include "HRam/HRam.hpp"
+#include "../../SaveState/SaveState.hpp"
 
+//Page map granularity. 256 byte pages keep OAM, IO and the boot rom off the fast path without splitting anything else.
+#define MMU_PAGE_SHIFT 8
+#define MMU_PAGE_SIZE 256
+#define MMU_PAGE_COUNT 256
+//160 M-cycles, the CPU is cut off from everything but HRAM and the IO registers meanwhile.
+#define OAM_DMA_CYCLES 640
+
+namespace GbMem
+{
 enum MemUnit
 {
 	VRAM, CART, OAM, IO_RAM, INT_RAM, INT_RAM_ECHO, INT_REG, BOOT_ROM, HRAM, NONE
 };
+}
+
+namespace GbWatch
+{
+enum WatchType
+{
+	READ = 0x01, WRITE = 0x02, ACCESS = 0x03
+};
+}
+
+//Fires after the access, value is the byte read or written.
+struct Watchpoint
+{
+	int id;
+	uint16_t startAddress;
+	uint16_t endAddress;
+	uint8_t type;
+	void (*callback)(void* instance, uint16_t address, uint8_t value, bool isWrite);
+	void* instance;
+};
 
 class MMU
 {
@@ -70,8 +102,25 @@ private:
 	//Echoed from 0xE000 to 0xFDFF
 	int ramStart = 0xC000, ramEnd = 0xDFFF;
 	int oamRamStart = 0xFE00, oamRamEnd = 0xFE9F;
-	int ioRamStart = 0xFF00, ioRamEnd = 0xFF4B;
-	int hRamStart = 0xFF80, hRamEnd = 0xFFFF; //Technically ends at 0xFFFE, but I'm hacking the IE register in. since it is nice and clean.
+	int ioRamStart = 0xFF00, ioRamEnd = 0xFF7F;
+	int hRamStart = 0xFF80, hRamEnd = 0xFFFE; //IE at 0xFFFF is dispatched through IoRam's register table.
+	//Page map, a non null entry points at the host bytes backing that page. nullptr falls through to the address decoder.
+	const uint8_t* readMap[MMU_PAGE_COUNT];
+	uint8_t* writeMap[MMU_PAGE_COUNT];
+	//Windows currently in the map, a bank write only rewrites the window that moved.
+	const uint8_t* bank0Window = nullptr;
+	const uint8_t* bank1Window = nullptr;
+	const uint8_t* exRamWindow = nullptr;
+	uint8_t* exRamWriteWindow = nullptr;
+	//Watchpoints per page. A watched page is left out of the page map so only its accesses reach the watch check.
+	uint8_t readWatchCount[MMU_PAGE_COUNT];
+	uint8_t writeWatchCount[MMU_PAGE_COUNT];
+	std::vector<Watchpoint> watchpoints;
+	int nextWatchId = 1;
+	//OAM DMA. The copy is done when it starts, the bus stays locked until the master clock passes dmaEndCycle.
+	const uint64_t* clock = nullptr;
+	bool dmaActive = false;
+	uint64_t dmaEndCycle = 0;
 	//Methods
 public:
 	MMU(Cartridge* cart, VRAM* vram, IoRam* ioRam, OamRam* oamRam);
@@ -79,9 +128,55 @@ public:
 
 	uint8_t read(uint16_t address);
 	void write(uint16_t address, uint8_t newValue);
+	//Copies length bytes starting at address, wrapping at 0xFFFF. Runs of mapped pages that are contiguous on the host are one memcpy.
+	//peek reads and writes the stored bytes without running IO handlers or touching the bank controller, rom writes are dropped.
+	void readBlock(uint16_t address, uint8_t* out, size_t length, bool peek);
+	void writeBlock(uint16_t address, const uint8_t* data, size_t length, bool peek);
+
+	//Returns the id for removeWatchpoint, -1 for a reversed range or if a page already holds the maximum of 255. Callbacks must not add or remove watchpoints.
+	int addWatchpoint(uint16_t startAddress, uint16_t endAddress, uint8_t type, void (*callback)(void*, uint16_t, uint8_t, bool), void* instance);
+	bool removeWatchpoint(int id);
+	void clearWatchpoints();
+
+	//Finishes a DMA that has run its course. Accesses finish it too, this only keeps the page map from staying off longer than needed.
+	void tick();
+	bool isDmaActive();
+	//Master clock in T-cycles, DMA timing needs it.
+	void attachClock(const uint64_t* clock);
+
+	//Power on state, boot rom mapped back in.
+	void reset();
+	//Leaves memory and IO as the boot rom would at 0x0100 and unmaps it. The CPU registers are the caller's.
+	void fastBoot();
+	bool isBootRomMapped();
+	uint16_t getPostBootAF();
+	//Rebuild the page map, needed whenever a memory is attached or the cart registers are loaded.
+	void remap();
+
+	InternalRam* getInternalRam();
+	HRam* getHRam();
+	IoRam* getIoRam();
 
+	//Memory contents are saved with the arena, this saves the MMU's own registers.
+	void saveState(SaveState* state);
+	bool loadState(SaveState* state);
 private:
-	MemUnit decodeAddress(uint16_t address);
+	uint8_t readSlow(uint16_t address);
+	void writeSlow(uint16_t address, uint8_t newValue);
+	//True while a DMA holds the bus and address is not on the CPU's own bus. Ends the DMA when its time is up.
+	bool isBusLocked(uint16_t address);
+	void finishDma();
+	uint8_t readWatched(uint16_t address);
+	void writeWatched(uint16_t address, uint8_t newValue);
+	void countWatch(Watchpoint* watch, int delta);
+	uint8_t peekSlow(uint16_t address);
+	void pokeSlow(uint16_t address, uint8_t newValue);
+	//Bytes from address to the end of the run of pages mapped back to back from the same host block, 0 if unmapped.
+	size_t mappedRun(const uint8_t* const* map, uint16_t address, size_t length);
+	void mapPages(uint16_t startAddress, uint16_t endAddress, const uint8_t* readBase, uint8_t* writeBase);
+	//Repoint the rom and cart ram windows at the banks the controller has selected.
+	void remapCartridge(bool force);
+	GbMem::MemUnit decodeAddress(uint16_t address);
 	uint8_t readVram(uint16_t address);
 	void writeVram(uint16_t address, uint8_t newValue);
 	uint8_t readOamRam(uint16_t address);
@@ -90,4 +185,7 @@ private:
 	void writeIoRam(uint16_t address, uint8_t newValue);
 	uint8_t readCartridge(uint16_t address);
 	void writeCartridge(uint16_t address, uint8_t newValue);
+	//IoRam handlers for the registers the MMU owns.
+	static void writeDma(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue);
+	static void writeBootRomDisable(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue);
 };
@@ -1,9 +1,9 @@
 /*==================================================================================
- *Class -
+ *Class - BankController
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - MBC1/MBC3/MBC5 bank registers. Turns writes to the rom area into bank offsets the MMU can point its page map at.
 ====================================================================================*/
 
 /*
@@ -31,28 +31,275 @@
 
 #pragma once
 
-#include "CHANGE.hpp"
+#include "BankController.hpp"
 
+BankController::BankController()
+{
 
+}
 
+BankController::~BankController()
+{
 
+}
 
+GbMbc::MbcType BankController::typeFromHeader(uint8_t cartType)
+{
+	switch(cartType)
+	{
+		case 0x01 : case 0x02 : case 0x03 :
+		{
+			return GbMbc::MBC1;
+		}
+		case 0x0F : case 0x10 : case 0x11 : case 0x12 : case 0x13 :
+		{
+			return GbMbc::MBC3;
+		}
+		case 0x19 : case 0x1A : case 0x1B : case 0x1C : case 0x1D : case 0x1E :
+		{
+			return GbMbc::MBC5;
+		}
+		default :
+		{
+			return GbMbc::NONE;
+		}
+	}
+}
 
+void BankController::configure(GbMbc::MbcType type, size_t romSize, size_t ramSize)
+{
+	this->type = type;
+	this->romBanks = romSize / 0x4000;
+	if(this->romBanks < 2)
+	{
+		this->romBanks = 2;
+	}
+	this->ramBanks = ramSize / 0x2000;
+	this->romMask = 1;
+	while(this->romMask < this->romBanks)
+	{
+		this->romMask <<= 1;
+	}
+	this->romMask--;
+	this->ramMask = 0;
+	while(this->ramMask < this->ramBanks)
+	{
+		this->ramMask = (this->ramMask << 1) | 1;
+	}
+	this->ramMask >>= 1;
+	this->reset();
+}
 
+void BankController::reset()
+{
+	this->romBank = 1;
+	this->ramBank = 0;
+	this->mode = 0;
+	//Plain rom carts have no enable register, their ram (if any) is always there.
+	this->ramEnabled = (this->type == GbMbc::NONE);
+	this->resolve();
+}
 
+bool BankController::write(uint16_t address, uint8_t newValue)
+{
+	size_t oldBank0 = this->bank0Offset;
+	size_t oldBank1 = this->bank1Offset;
+	long oldRam = this->ramOffset;
+	switch(this->type)
+	{
+		case GbMbc::MBC1 :
+		{
+			this->writeMbc1(address, newValue);
+			break;
+		}
+		case GbMbc::MBC3 :
+		{
+			this->writeMbc3(address, newValue);
+			break;
+		}
+		case GbMbc::MBC5 :
+		{
+			this->writeMbc5(address, newValue);
+			break;
+		}
+		default :
+		{
+			return false;
+		}
+	}
+	this->resolve();
+	return (oldBank0 != this->bank0Offset) || (oldBank1 != this->bank1Offset) || (oldRam != this->ramOffset);
+}
+
+void BankController::writeMbc1(uint16_t address, uint8_t newValue)
+{
+	if(address < 0x2000)
+	{
+		this->ramEnabled = ((newValue & 0x0F) == 0x0A);
+	}
+	else if(address < 0x4000)
+	{
+		//Low five bits, zero selects one.
+		uint8_t low = newValue & 0x1F;
+		this->romBank = (this->romBank & 0x60) | (low == 0 ? 1 : low);
+	}
+	else if(address < 0x6000)
+	{
+		//Shared two bit register, upper rom bits and the ram bank.
+		this->ramBank = newValue & 0x03;
+		this->romBank = (this->romBank & 0x1F) | ((newValue & 0x03) << 5);
+	}
+	else
+	{
+		this->mode = newValue & 0x01;
+	}
+}
 
+void BankController::writeMbc3(uint16_t address, uint8_t newValue)
+{
+	if(address < 0x2000)
+	{
+		this->ramEnabled = ((newValue & 0x0F) == 0x0A);
+	}
+	else if(address < 0x4000)
+	{
+		uint8_t bank = newValue & 0x7F;
+		this->romBank = (bank == 0 ? 1 : bank);
+	}
+	else if(address < 0x6000)
+	{
+		this->ramBank = newValue & 0x0F;
+	}
+	//0x6000-0x7FFF is the RTC latch, it does not move any window.
+}
+
+void BankController::writeMbc5(uint16_t address, uint8_t newValue)
+{
+	if(address < 0x2000)
+	{
+		this->ramEnabled = ((newValue & 0x0F) == 0x0A);
+	}
+	else if(address < 0x3000)
+	{
+		this->romBank = (this->romBank & 0x100) | newValue;
+	}
+	else if(address < 0x4000)
+	{
+		this->romBank = (this->romBank & 0x0FF) | ((newValue & 0x01) << 8);
+	}
+	else if(address < 0x6000)
+	{
+		this->ramBank = newValue & 0x0F;
+	}
+}
 
+void BankController::resolve()
+{
+	size_t bank0 = 0;
+	size_t bank1 = this->romBank;
+	size_t ram = 0;
+	switch(this->type)
+	{
+		case GbMbc::MBC1 :
+		{
+			//Mode 1 applies the upper bits to the 0x0000 window and the ram bank.
+			if(this->mode == 1)
+			{
+				bank0 = this->romBank & 0x60;
+				ram = this->ramBank;
+			}
+			break;
+		}
+		case GbMbc::MBC3 :
+		case GbMbc::MBC5 :
+		{
+			ram = this->ramBank;
+			break;
+		}
+		default :
+		{
+			bank1 = 1;
+			break;
+		}
+	}
+	bank0 &= this->romMask;
+	bank1 &= this->romMask;
+	//Odd sized dumps, the mask alone can still land past the end.
+	if(bank0 >= this->romBanks)
+	{
+		bank0 %= this->romBanks;
+	}
+	if(bank1 >= this->romBanks)
+	{
+		bank1 %= this->romBanks;
+	}
+	this->bank0Offset = bank0 * 0x4000;
+	this->bank1Offset = bank1 * 0x4000;
+	if(!this->ramEnabled || this->ramBanks == 0 || (this->type == GbMbc::MBC3 && this->ramBank > 0x07))
+	{
+		this->ramOffset = BANK_RAM_UNMAPPED;
+	}
+	else
+	{
+		ram &= this->ramMask;
+		if(ram >= this->ramBanks)
+		{
+			ram %= this->ramBanks;
+		}
+		this->ramOffset = (long)(ram * 0x2000);
+	}
+}
 
+GbMbc::MbcType BankController::getType()
+{
+	return this->type;
+}
 
+size_t BankController::getBank0Offset()
+{
+	return this->bank0Offset;
+}
 
+size_t BankController::getBank1Offset()
+{
+	return this->bank1Offset;
+}
 
+long BankController::getRamOffset()
+{
+	return this->ramOffset;
+}
 
+bool BankController::isRamEnabled()
+{
+	return this->ramEnabled;
+}
 
+uint8_t BankController::getRamSelect()
+{
+	return this->ramBank;
+}
 
+void BankController::saveState(SaveState* state)
+{
+	state->write(this->romBank);
+	state->write(this->ramBank);
+	state->write(this->mode);
+	state->write(this->ramEnabled);
+}
 
+bool BankController::loadState(SaveState* state)
+{
+	bool ok = state->read(this->romBank);
+	ok = ok && state->read(this->ramBank);
+	ok = ok && state->read(this->mode);
+	ok = ok && state->read(this->ramEnabled);
+	this->resolve();
+	return ok;
+}
 
 /*
-<++> CHANGE::<++>()
+<++> BankController::<++>()
 {
 
 }
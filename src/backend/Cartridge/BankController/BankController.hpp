@@ -1,9 +1,9 @@
 /*==================================================================================
- *Class -
+ *Class - BankController
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - MBC1/MBC3/MBC5 bank registers. Turns writes to the rom area into bank offsets the MMU can point its page map at.
 ====================================================================================*/
 
 /*
@@ -29,18 +29,70 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#pragma once
 
+#include <cstdint>
+#include <cstddef>
 
-class CHANGE
+#include "../../SaveState/SaveState.hpp"
+
+//No ram window mapped, either ram is disabled or an RTC register is selected.
+#define BANK_RAM_UNMAPPED -1
+
+namespace GbMbc
+{
+enum MbcType
+{
+	NONE, MBC1, MBC3, MBC5
+};
+}
+
+class BankController
 {
 	//Attributes
 public:
 
 private:
+	GbMbc::MbcType type = GbMbc::NONE;
+	size_t romBanks = 2;
+	size_t ramBanks = 0;
+	//Bank counts from the header are powers of two, the masks replace a divide on every register write.
+	size_t romMask = 1;
+	size_t ramMask = 0;
+	//Raw register values as last written.
+	uint16_t romBank = 1;
+	uint8_t ramBank = 0;
+	uint8_t mode = 0;
+	bool ramEnabled = false;
+	//Resolved offsets, recomputed on every register write so reads never touch the registers.
+	size_t bank0Offset = 0;
+	size_t bank1Offset = 0x4000;
+	long ramOffset = BANK_RAM_UNMAPPED;
 	//Methods
 public:
-	CHANGE();
-	~CHANGE();
+	BankController();
+	~BankController();
+
+	static GbMbc::MbcType typeFromHeader(uint8_t cartType);
+	void configure(GbMbc::MbcType type, size_t romSize, size_t ramSize);
+	void reset();
+
+	//Returns true when the write moved a window and the MMU needs to remap.
+	bool write(uint16_t address, uint8_t newValue);
+
+	GbMbc::MbcType getType();
+	size_t getBank0Offset();
+	size_t getBank1Offset();
+	long getRamOffset();
+	bool isRamEnabled();
+	//MBC3 0x08-0x0C selects an RTC register instead of a ram bank.
+	uint8_t getRamSelect();
 
+	void saveState(SaveState* state);
+	bool loadState(SaveState* state);
 private:
+	void writeMbc1(uint16_t address, uint8_t newValue);
+	void writeMbc3(uint16_t address, uint8_t newValue);
+	void writeMbc5(uint16_t address, uint8_t newValue);
+	void resolve();
 };
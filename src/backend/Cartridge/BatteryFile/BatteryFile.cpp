@@ -0,0 +1,334 @@
+/*==================================================================================
+ *Class - BatteryFile
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Battery backed cart ram as a MAP_SHARED .sav file. Writes mark host pages dirty, one process wide thread msyncs them every few seconds.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BatteryFile.hpp"
+
+//One flusher for the whole process, thousands of headless instances share a thread. MS_ASYNC only queues writeback, nothing blocks on the disk until close.
+namespace
+{
+struct BatteryFlusher
+{
+	std::mutex lock;
+	std::condition_variable wake;
+	std::set<BatteryFile*> files;
+	std::thread worker;
+	unsigned int interval = BATTERY_FLUSH_SECONDS;
+	bool stopping = false;
+
+	~BatteryFlusher()
+	{
+		{
+			std::lock_guard<std::mutex> guard(this->lock);
+			this->stopping = true;
+		}
+		this->wake.notify_all();
+		if(this->worker.joinable())
+		{
+			this->worker.join();
+		}
+	}
+
+	void run()
+	{
+		std::unique_lock<std::mutex> guard(this->lock);
+		while(!this->stopping)
+		{
+			this->wake.wait_for(guard, std::chrono::seconds(this->interval));
+			if(this->stopping)
+			{
+				break;
+			}
+			//Files unregister under the same lock, so none can be unmapped mid flush.
+			for(BatteryFile* file : this->files)
+			{
+				file->flush(false);
+			}
+		}
+	}
+};
+
+BatteryFlusher& flusher()
+{
+	static BatteryFlusher instance;
+	return instance;
+}
+}
+
+BatteryFile::BatteryFile() : dirtyPages(0)
+{
+	long pageSize = sysconf(_SC_PAGESIZE);
+	while(((long)1 << this->pageShift) < pageSize)
+	{
+		this->pageShift++;
+	}
+}
+
+BatteryFile::~BatteryFile()
+{
+	this->close();
+}
+
+bool BatteryFile::open(std::string path, uint8_t* ram, size_t ramSize, size_t trailerSize)
+{
+	this->close();
+	//Timer only carts (no ram) still keep their clock in the file.
+	if((ram == nullptr && ramSize > 0) || (ramSize >> this->pageShift) > 64)
+	{
+		return false;
+	}
+	this->fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if(this->fd < 0)
+	{
+		return false;
+	}
+	struct stat info;
+	if(fstat(this->fd, &info) != 0 || ((size_t)info.st_size < ramSize + trailerSize && ftruncate(this->fd, ramSize + trailerSize) != 0))
+	{
+		::close(this->fd);
+		this->fd = -1;
+		return false;
+	}
+	this->path = path;
+	this->ramSize = ramSize;
+	size_t pageSize = (size_t)1 << this->pageShift;
+	this->mappedSize = (ramSize + pageSize - 1) & ~(pageSize - 1);
+	if(ramSize > 0 && !this->mapOver(ram))
+	{
+		::close(this->fd);
+		this->fd = -1;
+		return false;
+	}
+	this->dirtyPages.store(0);
+	registerFile(this);
+	return true;
+}
+
+bool BatteryFile::mapOver(uint8_t* ram)
+{
+	this->ram = ram;
+	//Straight over the arena's pages, the emulator then writes the page cache directly.
+	void* shared = mmap(ram, this->mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, this->fd, 0);
+	if(shared != MAP_FAILED)
+	{
+		this->mapping = (uint8_t*)shared;
+		return true;
+	}
+	//A huge page arena can't be split, keep the ram where it is and copy dirty pages across on flush.
+	shared = mmap(nullptr, this->mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+	if(shared == MAP_FAILED)
+	{
+		this->mapping = nullptr;
+		return false;
+	}
+	this->mapping = (uint8_t*)shared;
+	std::memcpy(this->ram, this->mapping, this->ramSize);
+	return true;
+}
+
+void BatteryFile::close()
+{
+	if(this->fd < 0)
+	{
+		return;
+	}
+	unregisterFile(this);
+	this->flush(true);
+	this->unmap();
+}
+
+void BatteryFile::detach()
+{
+	if(this->fd < 0)
+	{
+		return;
+	}
+	//Out of the flusher before the mapping goes, it flushes under the same lock.
+	unregisterFile(this);
+	this->unmap();
+}
+
+void BatteryFile::forget()
+{
+	if(this->fd < 0)
+	{
+		return;
+	}
+	//The child's copy of the flusher has no thread, the stale entry is never walked.
+	this->unmap();
+}
+
+void BatteryFile::unmap()
+{
+	if(this->mapping != nullptr && this->mapping == this->ram)
+	{
+		//Put anonymous memory back under the arena so later writes don't reach the file.
+		uint8_t* copy = new uint8_t[this->ramSize];
+		std::memcpy(copy, this->ram, this->ramSize);
+		mmap(this->ram, this->mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+		std::memcpy(this->ram, copy, this->ramSize);
+		delete[] copy;
+	}
+	else if(this->mapping != nullptr)
+	{
+		munmap(this->mapping, this->mappedSize);
+	}
+	::close(this->fd);
+	this->fd = -1;
+	this->ram = nullptr;
+	this->mapping = nullptr;
+}
+
+bool BatteryFile::isOpen()
+{
+	return this->fd >= 0;
+}
+
+void BatteryFile::copyIn(const uint8_t* data, size_t length)
+{
+	size_t pageSize = (size_t)1 << this->pageShift;
+	if(length > this->ramSize)
+	{
+		length = this->ramSize;
+	}
+	for(size_t offset = 0; offset < length; offset += pageSize)
+	{
+		size_t chunk = (length - offset < pageSize) ? length - offset : pageSize;
+		if(std::memcmp(this->ram + offset, data + offset, chunk) != 0)
+		{
+			//Marked after the copy, a flush in between leaves the bit for the next one.
+			std::memcpy(this->ram + offset, data + offset, chunk);
+			this->markDirty(offset);
+		}
+	}
+}
+
+void BatteryFile::flush(bool wait)
+{
+	if(this->fd < 0)
+	{
+		return;
+	}
+	//Taken before copying, a write racing the copy leaves its page dirty for next time.
+	uint64_t dirty = this->dirtyPages.exchange(0, std::memory_order_relaxed);
+	size_t pageSize = (size_t)1 << this->pageShift;
+	while(dirty != 0)
+	{
+		//Coalesce runs of dirty pages into one msync.
+		int first = __builtin_ctzll(dirty);
+		int last = first;
+		while(last < 63 && (dirty & ((uint64_t)1 << (last + 1))))
+		{
+			last++;
+		}
+		size_t offset = (size_t)first * pageSize;
+		size_t length = (size_t)(last - first + 1) * pageSize;
+		if(offset + length > this->mappedSize)
+		{
+			length = this->mappedSize - offset;
+		}
+		if(this->mapping != this->ram)
+		{
+			size_t copyLength = (offset + length > this->ramSize) ? this->ramSize - offset : length;
+			std::memcpy(this->mapping + offset, this->ram + offset, copyLength);
+		}
+		msync(this->mapping + offset, length, wait ? MS_SYNC : MS_ASYNC);
+		for(int i = first; i <= last; i++)
+		{
+			dirty &= ~((uint64_t)1 << i);
+		}
+	}
+	if(wait)
+	{
+		fdatasync(this->fd);
+	}
+}
+
+bool BatteryFile::readTrailer(uint8_t* out, size_t size)
+{
+	if(this->fd < 0)
+	{
+		return false;
+	}
+	return pread(this->fd, out, size, this->ramSize) == (ssize_t)size;
+}
+
+bool BatteryFile::writeTrailer(const uint8_t* data, size_t size)
+{
+	if(this->fd < 0)
+	{
+		return false;
+	}
+	return pwrite(this->fd, data, size, this->ramSize) == (ssize_t)size;
+}
+
+void BatteryFile::setFlushInterval(unsigned int seconds)
+{
+	std::lock_guard<std::mutex> guard(flusher().lock);
+	flusher().interval = (seconds == 0) ? 1 : seconds;
+}
+
+void BatteryFile::registerFile(BatteryFile* file)
+{
+	BatteryFlusher& instance = flusher();
+	std::lock_guard<std::mutex> guard(instance.lock);
+	instance.files.insert(file);
+	if(!instance.worker.joinable())
+	{
+		instance.worker = std::thread(&BatteryFlusher::run, &instance);
+	}
+}
+
+void BatteryFile::unregisterFile(BatteryFile* file)
+{
+	BatteryFlusher& instance = flusher();
+	std::lock_guard<std::mutex> guard(instance.lock);
+	instance.files.erase(file);
+}
+
+/*
+<++> BatteryFile::<++>()
+{
+
+}
+*/
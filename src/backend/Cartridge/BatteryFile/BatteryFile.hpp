@@ -0,0 +1,98 @@
+/*==================================================================================
+ *Class - BatteryFile
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Battery backed cart ram as a MAP_SHARED .sav file. Writes mark host pages dirty, one process wide thread msyncs them every few seconds.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <string>
+
+//Background flush period, a lost power costs at most this much progress.
+#define BATTERY_FLUSH_SECONDS 5
+
+class BatteryFile
+{
+	//Attributes
+public:
+
+private:
+	int fd = -1;
+	std::string path;
+	//The emulated ram, and the file mapping. The same pointer unless the file could not be mapped over the ram (huge page arena).
+	uint8_t* ram = nullptr;
+	uint8_t* mapping = nullptr;
+	size_t ramSize = 0;
+	size_t mappedSize = 0;
+	size_t pageShift = 12;
+	//One bit per host page of ram. 128KB of cart ram is 32 pages on 4KB pages.
+	std::atomic<uint64_t> dirtyPages;
+	//Methods
+public:
+	BatteryFile();
+	~BatteryFile();
+
+	//Maps path (created and sized if needed) over ram. trailerSize bytes past the ram are kept for the RTC.
+	bool open(std::string path, uint8_t* ram, size_t ramSize, size_t trailerSize);
+	//Final synchronous flush, then the ram is left as ordinary anonymous memory with the same contents.
+	void close();
+	//Keeps the contents as private memory and drops the file without flushing.
+	void detach();
+	//detach for a forked child. Leaves the flusher alone, its lock may have been held at fork and its thread did not come along.
+	void forget();
+	bool isOpen();
+
+	inline void markDirty(size_t offset)
+	{
+		uint64_t bit = (uint64_t)1 << ((offset >> this->pageShift) & 63);
+		//Plain load first, a page already dirty costs no locked instruction.
+		if((this->dirtyPages.load(std::memory_order_relaxed) & bit) == 0)
+		{
+			this->dirtyPages.fetch_or(bit, std::memory_order_relaxed);
+		}
+	}
+	//State load. Copies data over the ram a page at a time, only pages whose bytes changed are flushed.
+	void copyIn(const uint8_t* data, size_t length);
+	//Writes dirty pages back. Async for the background thread, sync on close.
+	void flush(bool wait);
+
+	bool readTrailer(uint8_t* out, size_t size);
+	bool writeTrailer(const uint8_t* data, size_t size);
+
+	//Applies to every battery file in the process.
+	static void setFlushInterval(unsigned int seconds);
+private:
+	bool mapOver(uint8_t* ram);
+	void unmap();
+	static void registerFile(BatteryFile* file);
+	static void unregisterFile(BatteryFile* file);
+};
@@ -1,9 +1,9 @@
 /*==================================================================================
- *Class -
+ *Class - Cartridge
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 7/22/22
+ *Last Changed - 10/19/26
+ *Description - Gameboy Cartridge Model.
 ====================================================================================*/
 
 /*
@@ -31,28 +31,337 @@
 
 #pragma once
 
-#include "CHANGE.hpp"
+#include <cstring>
 
+#include "Cartridge.hpp"
 
+Cartridge::Cartridge()
+{
+
+}
+
+Cartridge::~Cartridge()
+{
+	this->closeBattery();
+}
+
+bool Cartridge::load(std::string romNamePath)
+{
+	this->closeBattery();
+	std::shared_ptr<Memory> image = Memory::open(romNamePath);
+	if(!image || image->getFileSize() <= CART_HEADER_CHECKSUM)
+	{
+		return false;
+	}
+	this->rom = image;
+	const uint8_t* data = this->rom->getData();
+	this->cartType = data[CART_HEADER_TYPE];
+	this->ramSize = decodeRamSize(data[CART_HEADER_RAM_SIZE]);
+	switch(this->cartType)
+	{
+		case 0x03 : case 0x06 : case 0x09 : case 0x0D : case 0x13 : case 0x1B : case 0x1E : case 0x22 : case 0xFF :
+		{
+			this->battery = true;
+			this->timer = false;
+			break;
+		}
+		case 0x0F : case 0x10 :
+		{
+			this->battery = true;
+			this->timer = true;
+			break;
+		}
+		default :
+		{
+			this->battery = false;
+			this->timer = false;
+			break;
+		}
+	}
+	this->ram = nullptr;
+	this->mbc.configure(BankController::typeFromHeader(this->cartType), this->rom->getSize(), this->ramSize);
+	this->rtc.reset();
+	return true;
+}
+
+void Cartridge::attachRam(uint8_t* memory)
+{
+	this->ram = memory;
+	//Power on contents, unless the ram is the save file.
+	if(this->ram != nullptr && !this->batteryFile.isOpen())
+	{
+		std::memset(this->ram, 0, this->ramSize);
+	}
+}
+
+void Cartridge::attachClock(const uint64_t* cycleCounter)
+{
+	this->rtc.attach(cycleCounter);
+}
+
+void Cartridge::setRealTimeClock(bool hostTime)
+{
+	this->rtc.setRealTime(hostTime);
+}
+
+void Cartridge::rebaseClock()
+{
+	this->rtc.rebase();
+}
+
+void Cartridge::reset()
+{
+	//The clock is battery backed, a reset leaves it running.
+	this->mbc.reset();
+	this->rtc.rebase();
+}
+
+uint8_t Cartridge::read(uint16_t address)
+{
+	if(!this->rom)
+	{
+		return 0xFF;
+	}
+	if(address < 0x8000)
+	{
+		return this->getRomWindow(address)[address & 0x3FFF];
+	}
+	if(address >= 0xA000 && address < 0xC000 && this->timer && this->mbc.isRamEnabled() && this->mbc.getRamSelect() >= 0x08)
+	{
+		return this->rtc.read(this->mbc.getRamSelect());
+	}
+	if(address >= 0xA000 && address < 0xC000 && this->ram != nullptr)
+	{
+		uint8_t* window = this->getRamWindow();
+		if(window != nullptr)
+		{
+			return window[address - 0xA000];
+		}
+		//Carts with less than a bank of ram mirror it through the window.
+		if(this->mbc.isRamEnabled() && this->ramSize < CART_RAM_BANK_SIZE)
+		{
+			return this->ram[(address - 0xA000) % this->ramSize];
+		}
+	}
+	return 0xFF;
+}
+
+bool Cartridge::write(uint16_t address, uint8_t newValue)
+{
+	if(address < 0x8000)
+	{
+		if(address >= 0x6000 && this->timer)
+		{
+			this->rtc.latchWrite(newValue);
+		}
+		return this->mbc.write(address, newValue);
+	}
+	if(address >= 0xA000 && address < 0xC000 && this->timer && this->mbc.isRamEnabled() && this->mbc.getRamSelect() >= 0x08)
+	{
+		this->rtc.write(this->mbc.getRamSelect(), newValue);
+		return false;
+	}
+	if(address >= 0xA000 && address < 0xC000 && this->ram != nullptr)
+	{
+		uint8_t* window = this->getRamWindow();
+		size_t offset;
+		if(window != nullptr)
+		{
+			offset = (size_t)(window - this->ram) + (address - 0xA000);
+		}
+		else if(this->mbc.isRamEnabled() && this->ramSize < CART_RAM_BANK_SIZE)
+		{
+			offset = (address - 0xA000) % this->ramSize;
+		}
+		else
+		{
+			return false;
+		}
+		this->ram[offset] = newValue;
+		if(this->batteryFile.isOpen())
+		{
+			this->batteryFile.markDirty(offset);
+		}
+	}
+	return false;
+}
+
+uint8_t* Cartridge::getRamWriteWindow()
+{
+	if(this->batteryFile.isOpen())
+	{
+		return nullptr;
+	}
+	return this->getRamWindow();
+}
+
+const uint8_t* Cartridge::getRomWindow(uint16_t address)
+{
+	if(!this->rom)
+	{
+		return nullptr;
+	}
+	size_t offset = (address < 0x4000) ? this->mbc.getBank0Offset() : this->mbc.getBank1Offset();
+	return this->rom->getData() + offset;
+}
+
+uint8_t* Cartridge::getRamWindow()
+{
+	long offset = this->mbc.getRamOffset();
+	if(this->ram == nullptr || offset == BANK_RAM_UNMAPPED)
+	{
+		return nullptr;
+	}
+	return this->ram + offset;
+}
+
+const uint8_t* Cartridge::getRom()
+{
+	return this->rom ? this->rom->getData() : nullptr;
+}
+
+size_t Cartridge::getRomSize()
+{
+	return this->rom ? this->rom->getSize() : 0;
+}
 
+uint8_t* Cartridge::getRam()
+{
+	return this->ram;
+}
+
+size_t Cartridge::getRamSize()
+{
+	return this->ramSize;
+}
 
+uint8_t Cartridge::getCartType()
+{
+	return this->cartType;
+}
 
+bool Cartridge::hasBattery()
+{
+	return this->battery;
+}
 
+bool Cartridge::hasTimer()
+{
+	return this->timer;
+}
 
+bool Cartridge::isLoaded()
+{
+	return (bool)this->rom;
+}
 
+void Cartridge::saveState(SaveState* state)
+{
+	this->mbc.saveState(state);
+	this->rtc.saveState(state);
+}
 
+bool Cartridge::loadState(SaveState* state)
+{
+	bool ok = this->mbc.loadState(state);
+	return ok && this->rtc.loadState(state);
+}
 
+bool Cartridge::loadRam(SaveState* state, size_t length)
+{
+	if(!this->batteryFile.isOpen())
+	{
+		return state->readBlock(this->ram, length);
+	}
+	const uint8_t* data = state->readSpan(length);
+	if(data == nullptr)
+	{
+		return false;
+	}
+	size_t fileBytes = (length < this->ramSize) ? length : this->ramSize;
+	this->batteryFile.copyIn(data, fileBytes);
+	std::memcpy(this->ram + fileBytes, data + fileBytes, length - fileBytes);
+	return true;
+}
 
+void Cartridge::saveClock(SaveState* state)
+{
+	this->rtc.saveState(state);
+}
 
+bool Cartridge::loadClock(SaveState* state)
+{
+	return this->rtc.loadState(state);
+}
 
+bool Cartridge::openBattery(std::string path)
+{
+	if(!this->battery)
+	{
+		return false;
+	}
+	size_t trailerSize = this->timer ? RTC_BATTERY_SIZE : 0;
+	if(!this->batteryFile.open(path, this->ram, (this->ram != nullptr) ? this->ramSize : 0, trailerSize))
+	{
+		return false;
+	}
+	if(this->timer)
+	{
+		uint8_t trailer[RTC_BATTERY_SIZE];
+		//A fresh file reads back zeros, a clock at day 0 with no timestamp to catch up from.
+		if(this->batteryFile.readTrailer(trailer, RTC_BATTERY_SIZE))
+		{
+			this->rtc.loadBattery(trailer, RTC_BATTERY_SIZE);
+		}
+	}
+	return true;
+}
 
+void Cartridge::closeBattery()
+{
+	if(!this->batteryFile.isOpen())
+	{
+		return;
+	}
+	if(this->timer)
+	{
+		uint8_t trailer[RTC_BATTERY_SIZE];
+		this->rtc.saveBattery(trailer);
+		this->batteryFile.writeTrailer(trailer, RTC_BATTERY_SIZE);
+	}
+	this->batteryFile.close();
+}
 
+bool Cartridge::isBatteryOpen()
+{
+	return this->batteryFile.isOpen();
+}
 
+void Cartridge::detachBattery()
+{
+	this->batteryFile.detach();
+}
 
+void Cartridge::forgetBattery()
+{
+	this->batteryFile.forget();
+}
 
+size_t Cartridge::decodeRamSize(uint8_t code)
+{
+	switch(code)
+	{
+		case 0x01 : return 2048;
+		case 0x02 : return 8192;
+		case 0x03 : return 32768;
+		case 0x04 : return 131072;
+		case 0x05 : return 65536;
+		default : return 0;
+	}
+}
 
 /*
-<++> CHANGE::<++>()
+<++> Cartridge::<++>()
 {
 
 }
@@ -2,7 +2,7 @@
  *Class - Cartridge
  *Author - Zach Walden
  *Created - 7/22/22
- *Last Changed - 7/22/22
+ *Last Changed - 10/19/26
  *Description - Gameboy Cartridge Model.
 ====================================================================================*/
 
@@ -29,7 +29,26 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#pragma once
 
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "Memory/Memory.hpp"
+#include "BankController/BankController.hpp"
+#include "RealTimeClock/RealTimeClock.hpp"
+#include "BatteryFile/BatteryFile.hpp"
+#include "../SaveState/SaveState.hpp"
+
+//Cartridge header fields
+#define CART_HEADER_TITLE 0x0134
+#define CART_HEADER_TYPE 0x0147
+#define CART_HEADER_ROM_SIZE 0x0148
+#define CART_HEADER_RAM_SIZE 0x0149
+#define CART_HEADER_CHECKSUM 0x014D
+#define CART_RAM_BANK_SIZE 8192
 
 class Cartridge
 {
@@ -37,10 +56,68 @@ class Cartridge
 public:
 
 private:
+	std::shared_ptr<Memory> rom;
+	//Cart ram lives in the GameBoy's arena.
+	uint8_t* ram = nullptr;
+	size_t ramSize = 0;
+	uint8_t cartType = 0;
+	bool battery = false;
+	bool timer = false;
+	BankController mbc;
+	RealTimeClock rtc;
+	BatteryFile batteryFile;
 	//Methods
 public:
 	Cartridge();
 	~Cartridge();
 
+	//Maps the rom and reads its header. Does not touch ram, the GameBoy sizes the arena from getRamSize() and attaches it.
+	bool load(std::string romNamePath);
+	void attachRam(uint8_t* memory);
+	//The clock reads elapsed time off the GameBoy's cycle counter.
+	void attachClock(const uint64_t* cycleCounter);
+	void setRealTimeClock(bool hostTime);
+	//Folds the clock's elapsed time in. Call before the cycle counter jumps, reset re-anchors it afterwards.
+	void rebaseClock();
+	//Bank registers back to power on.
+	void reset();
+
+	//Slow path, the MMU only lands here for unmapped windows and register writes.
+	uint8_t read(uint16_t address);
+	//Returns true when a bank window moved and the MMU has to repoint its pages.
+	bool write(uint16_t address, uint8_t newValue);
+
+	//Start of the selected bank for the 16KB window holding address (0x0000 or 0x4000).
+	const uint8_t* getRomWindow(uint16_t address);
+	//Start of the selected 8KB ram bank, nullptr when ram is disabled or not a full bank.
+	uint8_t* getRamWindow();
+	//Same, but nullptr while a battery file is open so writes take the slow path and mark their page dirty.
+	uint8_t* getRamWriteWindow();
+
+	const uint8_t* getRom();
+	size_t getRomSize();
+	uint8_t* getRam();
+	size_t getRamSize();
+	uint8_t getCartType();
+	bool hasBattery();
+	bool hasTimer();
+	bool isLoaded();
+
+	void saveState(SaveState* state);
+	bool loadState(SaveState* state);
+	//Cart ram out of a state, through the battery file's dirty tracking when one is open. length may run past the ram into page padding.
+	bool loadRam(SaveState* state, size_t length);
+	//Just the clock, carried across a reset that restores everything else.
+	void saveClock(SaveState* state);
+	bool loadClock(SaveState* state);
+	//Maps the .sav file over cart ram, ram followed by the clock trailer on timer carts. Flushed in the background and on close.
+	bool openBattery(std::string path);
+	void closeBattery();
+	bool isBatteryOpen();
+	//Cart ram becomes private, the save file is left as it is.
+	void detachBattery();
+	//detachBattery for a forked child, the save file stays the parent's.
+	void forgetBattery();
 private:
+	static size_t decodeRamSize(uint8_t code);
 };
@@ -1,9 +1,9 @@
 /*==================================================================================
- *Class -
+ *Class - Memory
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Read only rom image. The file is mmap'd MAP_PRIVATE and shared by every instance in the process (and forked children) that loads the same file.
 ====================================================================================*/
 
 /*
@@ -31,28 +31,110 @@
 
 #pragma once
 
-#include "CHANGE.hpp"
-
-
-
-
-
-
+#include "Memory.hpp"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include <map>
+#include <mutex>
+#include <tuple>
 
+//Identifies the file itself rather than the path, and notices a rom rebuilt in place.
+typedef std::tuple<dev_t, ino_t, off_t, int64_t> RomKey;
 
+static std::mutex romCacheLock;
+static std::map<RomKey, std::weak_ptr<Memory>> romCache;
 
+std::shared_ptr<Memory> Memory::open(std::string path)
+{
+	struct stat info;
+	if(stat(path.c_str(), &info) != 0 || info.st_size <= 0)
+	{
+		return nullptr;
+	}
+	RomKey key(info.st_dev, info.st_ino, info.st_size, (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec);
+	std::lock_guard<std::mutex> guard(romCacheLock);
+	std::shared_ptr<Memory> rom = romCache[key].lock();
+	if(rom)
+	{
+		return rom;
+	}
+	rom = std::shared_ptr<Memory>(new Memory());
+	if(!rom->map(path, (size_t)info.st_size))
+	{
+		romCache.erase(key);
+		return nullptr;
+	}
+	romCache[key] = rom;
+	return rom;
+}
 
+Memory::Memory()
+{
 
+}
 
+Memory::~Memory()
+{
+	if(this->data != nullptr)
+	{
+		munmap(this->data, this->size);
+	}
+}
 
+const uint8_t* Memory::getData()
+{
+	return this->data;
+}
 
+size_t Memory::getSize()
+{
+	return this->size;
+}
 
+size_t Memory::getFileSize()
+{
+	return this->fileSize;
+}
 
+bool Memory::map(std::string path, size_t length)
+{
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+	{
+		return false;
+	}
+	size_t padded = (length + ROM_BANK_SIZE - 1) & ~(size_t)(ROM_BANK_SIZE - 1);
+	if(padded < ROM_MIN_SIZE)
+	{
+		padded = ROM_MIN_SIZE;
+	}
+	//Reserve the padded size as zero pages, then lay the file over the front of it.
+	//Touching a file mapping past its last page is a SIGBUS, touching the reservation is not.
+	void* reserve = mmap(nullptr, padded, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(reserve == MAP_FAILED)
+	{
+		close(fd);
+		return false;
+	}
+	void* file = mmap(reserve, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+	close(fd);
+	if(file == MAP_FAILED)
+	{
+		munmap(reserve, padded);
+		return false;
+	}
+	this->data = (uint8_t*)file;
+	this->size = padded;
+	this->fileSize = length;
+	return true;
+}
 
 /*
-<++> CHANGE::<++>()
+<++> Memory::<++>()
 {
 
 }
@@ -1,9 +1,9 @@
 /*==================================================================================
- *Class -
+ *Class - Memory
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Read only rom image. The file is mmap'd MAP_PRIVATE and shared by every instance in the process (and forked children) that loads the same file.
 ====================================================================================*/
 
 /*
@@ -29,18 +29,38 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#pragma once
 
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
 
-class CHANGE
+//Images are padded to at least two banks so bank 0 and 1 always exist.
+#define ROM_BANK_SIZE 16384
+#define ROM_MIN_SIZE (2 * ROM_BANK_SIZE)
+
+class Memory
 {
 	//Attributes
 public:
 
 private:
+	uint8_t* data = nullptr;
+	//Bytes mapped, the file rounded up to whole banks.
+	size_t size = 0;
+	size_t fileSize = 0;
 	//Methods
 public:
-	CHANGE();
-	~CHANGE();
+	//Returns the mapping already open for this file if there is one, so loading is nearly free after the first instance.
+	static std::shared_ptr<Memory> open(std::string path);
+
+	Memory();
+	~Memory();
 
+	const uint8_t* getData();
+	size_t getSize();
+	size_t getFileSize();
 private:
+	bool map(std::string path, size_t length);
 };
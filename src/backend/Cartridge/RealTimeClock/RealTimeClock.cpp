@@ -0,0 +1,286 @@
+/*==================================================================================
+ *Class - RealTimeClock
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - MBC3 clock. Nothing ticks, the registers are derived from a stored epoch and the master cycle counter (or host time) when latched or written.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <chrono>
+
+#include "RealTimeClock.hpp"
+
+RealTimeClock::RealTimeClock()
+{
+
+}
+
+RealTimeClock::~RealTimeClock()
+{
+
+}
+
+void RealTimeClock::attach(const uint64_t* cycleCounter)
+{
+	this->cycleCounter = cycleCounter;
+	this->rebase();
+}
+
+void RealTimeClock::setRealTime(bool enabled)
+{
+	//Fold the time so far into the base before switching sources.
+	this->rebase();
+	this->realTime = enabled;
+	this->rebase();
+}
+
+void RealTimeClock::reset()
+{
+	this->baseTicks = 0;
+	this->halted = false;
+	this->dayCarry = false;
+	this->latchPrimed = 0xFF;
+	for(int i = 0; i < 5; i++)
+	{
+		this->latched[i] = 0;
+	}
+	this->rebase();
+}
+
+void RealTimeClock::latchWrite(uint8_t newValue)
+{
+	if(this->latchPrimed == 0x00 && newValue == 0x01)
+	{
+		this->compute(this->latched);
+	}
+	this->latchPrimed = newValue;
+}
+
+uint8_t RealTimeClock::read(uint8_t select)
+{
+	if(select < 0x08 || select > 0x0C)
+	{
+		return 0xFF;
+	}
+	return this->latched[select - 0x08];
+}
+
+void RealTimeClock::write(uint8_t select, uint8_t newValue)
+{
+	if(select < 0x08 || select > 0x0C)
+	{
+		return;
+	}
+	uint8_t regs[5];
+	this->compute(regs);
+	uint64_t subSecond = this->baseTicks % RTC_CYCLES_PER_SECOND;
+	GbRtc::RtcRegister reg = (GbRtc::RtcRegister)(select - 0x08);
+	switch(reg)
+	{
+		case GbRtc::SECONDS :
+		{
+			//Writing seconds clears the divider.
+			regs[GbRtc::SECONDS] = newValue & 0x3F;
+			subSecond = 0;
+			break;
+		}
+		case GbRtc::MINUTES :
+		{
+			regs[GbRtc::MINUTES] = newValue & 0x3F;
+			break;
+		}
+		case GbRtc::HOURS :
+		{
+			regs[GbRtc::HOURS] = newValue & 0x1F;
+			break;
+		}
+		case GbRtc::DAY_LOW :
+		{
+			regs[GbRtc::DAY_LOW] = newValue;
+			break;
+		}
+		case GbRtc::DAY_HIGH :
+		{
+			regs[GbRtc::DAY_HIGH] = newValue & 0xC1;
+			this->halted = (newValue & 0x40) != 0;
+			this->dayCarry = (newValue & 0x80) != 0;
+			break;
+		}
+		default :
+		{
+			break;
+		}
+	}
+	uint64_t days = regs[GbRtc::DAY_LOW] | ((uint64_t)(regs[GbRtc::DAY_HIGH] & 0x01) << 8);
+	//Out of range values (a 63 in seconds) fold into the total and come back normalised on the next latch.
+	uint64_t seconds = regs[GbRtc::SECONDS] + regs[GbRtc::MINUTES] * 60 + regs[GbRtc::HOURS] * 3600 + days * RTC_SECONDS_PER_DAY;
+	this->baseTicks = seconds * RTC_CYCLES_PER_SECOND + subSecond;
+}
+
+void RealTimeClock::saveState(SaveState* state)
+{
+	this->rebase();
+	state->write(this->baseTicks);
+	state->write(this->halted);
+	state->write(this->dayCarry);
+	state->write(this->latchPrimed);
+	state->writeBlock(this->latched, sizeof(this->latched));
+}
+
+bool RealTimeClock::loadState(SaveState* state)
+{
+	bool ok = state->read(this->baseTicks);
+	ok = ok && state->read(this->halted);
+	ok = ok && state->read(this->dayCarry);
+	ok = ok && state->read(this->latchPrimed);
+	ok = ok && state->readBlock(this->latched, sizeof(this->latched));
+	//Counter has already been restored, the saved clock value starts again from here.
+	this->baseCycle = (this->cycleCounter != nullptr) ? *this->cycleCounter : 0;
+	this->baseHostNs = hostNs();
+	return ok;
+}
+
+void RealTimeClock::saveBattery(uint8_t* out)
+{
+	uint8_t regs[5];
+	this->compute(regs);
+	uint64_t words[10];
+	for(int i = 0; i < 5; i++)
+	{
+		words[i] = regs[i];
+		words[i + 5] = this->latched[i];
+	}
+	for(int i = 0; i < 10; i++)
+	{
+		for(int b = 0; b < 4; b++)
+		{
+			out[i * 4 + b] = (uint8_t)(words[i] >> (b * 8));
+		}
+	}
+	int64_t stamp = hostNs() / 1000000000;
+	for(int b = 0; b < 8; b++)
+	{
+		out[40 + b] = (uint8_t)((uint64_t)stamp >> (b * 8));
+	}
+}
+
+bool RealTimeClock::loadBattery(const uint8_t* in, size_t size)
+{
+	//Older files carry a 32 bit stamp.
+	if(size < RTC_BATTERY_SIZE - 4)
+	{
+		return false;
+	}
+	uint32_t words[10];
+	for(int i = 0; i < 10; i++)
+	{
+		words[i] = in[i * 4] | (in[i * 4 + 1] << 8) | (in[i * 4 + 2] << 16) | ((uint32_t)in[i * 4 + 3] << 24);
+	}
+	uint64_t stamp = 0;
+	for(int b = 0; b < ((size >= RTC_BATTERY_SIZE) ? 8 : 4); b++)
+	{
+		stamp |= (uint64_t)in[40 + b] << (b * 8);
+	}
+	this->halted = false;
+	this->write(0x0C, (uint8_t)words[GbRtc::DAY_HIGH]);
+	this->write(0x0B, (uint8_t)words[GbRtc::DAY_LOW]);
+	this->write(0x0A, (uint8_t)words[GbRtc::HOURS]);
+	this->write(0x09, (uint8_t)words[GbRtc::MINUTES]);
+	this->write(0x08, (uint8_t)words[GbRtc::SECONDS]);
+	for(int i = 0; i < 5; i++)
+	{
+		this->latched[i] = (uint8_t)words[i + 5];
+	}
+	this->rebase();
+	//On the host clock the cart kept running while the emulator was closed.
+	int64_t nowSeconds = hostNs() / 1000000000;
+	if(this->realTime && !this->halted && stamp != 0 && (int64_t)stamp < nowSeconds)
+	{
+		this->baseTicks += (uint64_t)(nowSeconds - (int64_t)stamp) * RTC_CYCLES_PER_SECOND;
+	}
+	return true;
+}
+
+uint64_t RealTimeClock::now()
+{
+	if(this->halted)
+	{
+		return this->baseTicks;
+	}
+	if(this->realTime)
+	{
+		int64_t elapsed = hostNs() - this->baseHostNs;
+		if(elapsed < 0)
+		{
+			elapsed = 0;
+		}
+		return this->baseTicks + (uint64_t)((__int128)elapsed * RTC_CYCLES_PER_SECOND / 1000000000);
+	}
+	uint64_t cycle = (this->cycleCounter != nullptr) ? *this->cycleCounter : 0;
+	//Counter went backwards (state load, reboot), nothing has elapsed.
+	return this->baseTicks + ((cycle > this->baseCycle) ? cycle - this->baseCycle : 0);
+}
+
+void RealTimeClock::rebase()
+{
+	this->baseTicks = this->now();
+	this->baseCycle = (this->cycleCounter != nullptr) ? *this->cycleCounter : 0;
+	this->baseHostNs = hostNs();
+	//Fold whole 512 day periods into the carry so the base never grows without bound.
+	uint64_t period = (uint64_t)RTC_DAY_LIMIT * RTC_SECONDS_PER_DAY * RTC_CYCLES_PER_SECOND;
+	if(this->baseTicks >= period)
+	{
+		this->baseTicks %= period;
+		this->dayCarry = true;
+	}
+}
+
+void RealTimeClock::compute(uint8_t* regs)
+{
+	this->rebase();
+	uint64_t seconds = this->baseTicks / RTC_CYCLES_PER_SECOND;
+	uint64_t days = seconds / RTC_SECONDS_PER_DAY;
+	regs[GbRtc::SECONDS] = (uint8_t)(seconds % 60);
+	regs[GbRtc::MINUTES] = (uint8_t)((seconds / 60) % 60);
+	regs[GbRtc::HOURS] = (uint8_t)((seconds / 3600) % 24);
+	regs[GbRtc::DAY_LOW] = (uint8_t)(days & 0xFF);
+	regs[GbRtc::DAY_HIGH] = (uint8_t)(((days >> 8) & 0x01) | (this->halted ? 0x40 : 0x00) | (this->dayCarry ? 0x80 : 0x00));
+}
+
+int64_t RealTimeClock::hostNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/*
+<++> RealTimeClock::<++>()
+{
+
+}
+*/
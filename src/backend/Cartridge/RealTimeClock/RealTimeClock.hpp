@@ -0,0 +1,98 @@
+/*==================================================================================
+ *Class - RealTimeClock
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - MBC3 clock. Nothing ticks, the registers are derived from a stored epoch and the master cycle counter (or host time) when latched or written.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "../../SaveState/SaveState.hpp"
+
+#define RTC_CYCLES_PER_SECOND 4194304
+#define RTC_SECONDS_PER_DAY 86400
+//Day counter is 9 bits, past that the carry flag sets and the count wraps.
+#define RTC_DAY_LIMIT 512
+//Trailer appended to battery files, the layout most emulators share: 5 clock and 5 latched registers as 32 bit words, then a 64 bit unix time.
+#define RTC_BATTERY_SIZE 48
+
+namespace GbRtc
+{
+enum RtcRegister
+{
+	SECONDS, MINUTES, HOURS, DAY_LOW, DAY_HIGH
+};
+}
+
+class RealTimeClock
+{
+	//Attributes
+public:
+
+private:
+	//Clock value in cycles at the last rebase, and where the counter (or host clock) stood then.
+	uint64_t baseTicks = 0;
+	uint64_t baseCycle = 0;
+	int64_t baseHostNs = 0;
+	const uint64_t* cycleCounter = nullptr;
+	bool realTime = false;
+	bool halted = false;
+	bool dayCarry = false;
+	uint8_t latched[5] = {0, 0, 0, 0, 0};
+	uint8_t latchPrimed = 0xFF;
+	//Methods
+public:
+	RealTimeClock();
+	~RealTimeClock();
+
+	//Emulated time follows the master cycle counter, so it replays exactly with states and movies.
+	void attach(const uint64_t* cycleCounter);
+	//Follow the host's wall clock instead, what a player expects from a battery cart.
+	void setRealTime(bool enabled);
+	void reset();
+	//Fold elapsed time into the base and re-anchor on the counter as it stands. When the counter jumps (reboot) call it
+	//before, so the time so far is kept, and again after, so nothing is measured from the old value.
+	void rebase();
+
+	//0x6000-0x7FFF, a 0x00 then 0x01 copies the clock into the readable registers.
+	void latchWrite(uint8_t newValue);
+	uint8_t read(uint8_t select);
+	void write(uint8_t select, uint8_t newValue);
+
+	void saveState(SaveState* state);
+	bool loadState(SaveState* state);
+	void saveBattery(uint8_t* out);
+	bool loadBattery(const uint8_t* in, size_t size);
+private:
+	uint64_t now();
+	void compute(uint8_t* regs);
+	static int64_t hostNs();
+};
@@ -29,6 +29,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#pragma once
+
 #include <cstdint>
 
 class CycleListener
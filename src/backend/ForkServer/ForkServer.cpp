@@ -0,0 +1,208 @@
+/*==================================================================================
+ *Class - ForkServer
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Zygote for process isolated jobs. Boots a rom once, then forks a child per job that starts from the warm state through copy on write and reports back over a pipe.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <sstream>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "ForkServer.hpp"
+
+ForkServer::ForkServer()
+{
+
+}
+
+ForkServer::~ForkServer()
+{
+
+}
+
+bool ForkServer::prepare(std::string romNamePath, bool fastBoot, uint32_t warmupFrames)
+{
+	this->gameBoy.setFastBoot(fastBoot);
+	if(!this->gameBoy.loadRom(romNamePath))
+	{
+		return false;
+	}
+	for(uint32_t i = 0; i < warmupFrames; i++)
+	{
+		this->gameBoy.runFrame();
+	}
+	if(warmupFrames > 0)
+	{
+		this->gameBoy.setStartState();
+	}
+	this->ready = true;
+	return true;
+}
+
+bool ForkServer::startJob(ForkJob* job)
+{
+	int fds[2];
+	if(!this->ready || pipe(fds) != 0)
+	{
+		return false;
+	}
+	job->forkNs = nowNs();
+	pid_t pid = fork();
+	if(pid < 0)
+	{
+		close(fds[0]);
+		close(fds[1]);
+		return false;
+	}
+	if(pid == 0)
+	{
+		//Child. Not async signal safe: the job allocates and runs the emulator, which relies on glibc's fork handlers keeping malloc
+		//usable after a fork from a threaded parent. What it does avoid is locks only our own threads take (the battery flusher),
+		//and destructors of the parent's objects, leaving with _exit.
+		close(fds[0]);
+		uint64_t startNs = nowNs();
+		this->gameBoy.forgetBattery();
+		std::vector<uint8_t> result;
+		uint32_t succeeded = job->run(job->context, &this->gameBoy, &result) ? 1 : 0;
+		uint64_t length = (result.size() > FORK_MAX_RESULT) ? FORK_MAX_RESULT : result.size();
+		bool ok = writeAll(fds[1], &startNs, sizeof(startNs));
+		ok = ok && writeAll(fds[1], &succeeded, sizeof(succeeded));
+		ok = ok && writeAll(fds[1], &length, sizeof(length));
+		ok = ok && writeAll(fds[1], result.data(), length);
+		_exit(ok ? 0 : 1);
+	}
+	close(fds[1]);
+	job->pid = pid;
+	job->readFd = fds[0];
+	return true;
+}
+
+bool ForkServer::finishJob(ForkJob* job)
+{
+	uint32_t succeeded = 0;
+	uint64_t length = 0;
+	job->succeeded = false;
+	job->result.clear();
+	//A child that died early just leaves the pipe short.
+	bool ok = readAll(job->readFd, &job->startNs, sizeof(job->startNs));
+	ok = ok && readAll(job->readFd, &succeeded, sizeof(succeeded));
+	ok = ok && readAll(job->readFd, &length, sizeof(length)) && length <= FORK_MAX_RESULT;
+	if(ok)
+	{
+		job->result.resize(length);
+		ok = readAll(job->readFd, job->result.data(), length);
+	}
+	close(job->readFd);
+	job->readFd = -1;
+	waitpid(job->pid, &job->exitStatus, 0);
+	if(!ok)
+	{
+		return false;
+	}
+	job->succeeded = (succeeded == 1);
+	uint64_t startup = (job->startNs > job->forkNs) ? job->startNs - job->forkNs : 0;
+	this->jobCount++;
+	this->totalStartupNs += startup;
+	if(startup > this->maxStartupNs)
+	{
+		this->maxStartupNs = startup;
+	}
+	return true;
+}
+
+bool ForkServer::runJob(ForkJob* job)
+{
+	return this->startJob(job) && this->finishJob(job);
+}
+
+std::string ForkServer::getStartupReport()
+{
+	std::ostringstream report;
+	report << "Jobs: " << this->jobCount;
+	if(this->jobCount > 0)
+	{
+		report << ", fork to job start avg " << (this->totalStartupNs / this->jobCount) / 1000.0 << " us, max " << this->maxStartupNs / 1000.0 << " us";
+	}
+	report << "\n";
+	return report.str();
+}
+
+GameBoy* ForkServer::getGameBoy()
+{
+	return &this->gameBoy;
+}
+
+uint64_t ForkServer::nowNs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+bool ForkServer::writeAll(int fd, const void* data, size_t length)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	while(length > 0)
+	{
+		ssize_t written = write(fd, bytes, length);
+		if(written <= 0)
+		{
+			return false;
+		}
+		bytes += written;
+		length -= written;
+	}
+	return true;
+}
+
+bool ForkServer::readAll(int fd, void* data, size_t length)
+{
+	uint8_t* bytes = (uint8_t*)data;
+	while(length > 0)
+	{
+		ssize_t got = read(fd, bytes, length);
+		if(got <= 0)
+		{
+			return false;
+		}
+		bytes += got;
+		length -= got;
+	}
+	return true;
+}
+
+/*
+<++> ForkServer::<++>()
+{
+
+}
+*/
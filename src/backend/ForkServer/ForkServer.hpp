@@ -0,0 +1,94 @@
+/*==================================================================================
+ *Class - ForkServer
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Zygote for process isolated jobs. Boots a rom once, then forks a child per job that starts from the warm state through copy on write and reports back over a pipe.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include "../GameBoy.hpp"
+
+//Job results larger than this are cut off, the pipe is not meant for bulk data.
+#define FORK_MAX_RESULT (16 * 1024 * 1024)
+
+//One job. The function runs in the child against the zygote's GameBoy, fills result and returns success.
+struct ForkJob
+{
+	bool (*run)(void* context, GameBoy* gameBoy, std::vector<uint8_t>* result);
+	void* context;
+	//Filled in by the server.
+	pid_t pid;
+	int readFd;
+	//Parent's clock at fork() and the child's when it reached the job, same CLOCK_MONOTONIC in both.
+	uint64_t forkNs;
+	uint64_t startNs;
+	std::vector<uint8_t> result;
+	bool succeeded;
+	//Raw waitpid status, a crash shows up here rather than in the parent.
+	int exitStatus;
+};
+
+class ForkServer
+{
+	//Attributes
+public:
+
+private:
+	GameBoy gameBoy;
+	bool ready = false;
+	uint64_t jobCount = 0;
+	uint64_t totalStartupNs = 0;
+	uint64_t maxStartupNs = 0;
+	//Methods
+public:
+	ForkServer();
+	~ForkServer();
+
+	//Loads and boots once, then runs warmupFrames and makes that the start state every child sees.
+	bool prepare(std::string romNamePath, bool fastBoot, uint32_t warmupFrames);
+
+	//Forks the child and returns, so several jobs can be in flight. finishJob collects it.
+	bool startJob(ForkJob* job);
+	bool finishJob(ForkJob* job);
+	bool runJob(ForkJob* job);
+
+	//Fork to job start latency over every job so far.
+	std::string getStartupReport();
+	GameBoy* getGameBoy();
+private:
+	static uint64_t nowNs();
+	static bool writeAll(int fd, const void* data, size_t length);
+	static bool readAll(int fd, void* data, size_t length);
+};
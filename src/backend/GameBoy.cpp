@@ -1,9 +1,9 @@
 /*==================================================================================
- *Class -
+ *Class - GameBoy
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 7/22/22
+ *Last Changed - 10/19/26
+ *Description - Top Level GameBoy Module/Class
 ====================================================================================*/
 
 /*
@@ -31,28 +31,600 @@
 
 #pragma once
 
-#include "CHANGE.hpp"
+#include "GameBoy.hpp"
 
+#include <cstring>
+#include <sstream>
 
+GameBoy::GameBoy() : GameBoy(false)
+{
+
+}
+
+GameBoy::GameBoy(bool useHugePages) :
+	mmu(&this->cart, &this->vram, &this->ioRam, &this->oamRam),
+	intController(&this->mmu, &this->regFile, &this->cycleListener),
+	execute(&this->mmu, &this->intController, &this->regFile),
+	ppu(&this->ioRam, &this->vram, &this->oamRam)
+{
+	this->useHugePages = useHugePages;
+	this->execute.registerCycleWatchCalback(&this->cycleListener);
+	this->cart.attachClock(&this->cycleCount);
+	this->mmu.attachClock(&this->cycleCount);
+	this->attachArena(0);
+}
+
+GameBoy::~GameBoy()
+{
+	delete this->lineOutput;
+}
+
+bool GameBoy::isReady()
+{
+	return this->arenaReady;
+}
+
+bool GameBoy::saveState(std::string saveStateNamePath)
+{
+	this->captureState(&this->fileState);
+	return this->fileState.saveToFile(saveStateNamePath);
+}
+
+bool GameBoy::loadState(std::string saveStateNamePath)
+{
+	if(!this->fileState.loadFromFile(saveStateNamePath))
+	{
+		return false;
+	}
+	return this->restoreState(&this->fileState);
+}
+
+void GameBoy::captureState(SaveState* state)
+{
+	state->clear();
+	state->write((uint32_t)SAVE_STATE_MAGIC);
+	state->write((uint32_t)SAVE_STATE_VERSION);
+	//Everything a restore checks before it touches the machine.
+	state->write(this->romHash);
+	state->write((uint64_t)this->arena.getUsedSize());
+	size_t sizeAt = state->getSize();
+	state->write((uint64_t)0);
+	state->write(this->cycleCount);
+	state->write(this->frameCount);
+	this->regFile.saveState(state);
+	this->intController.saveState(state);
+	this->mmu.saveState(state);
+	this->ioRam.saveState(state);
+	this->ppu.saveState(state);
+	//Every memory lives in the arena, one copy covers them all.
+	state->writeBlock(this->arena.getData(), this->arena.getUsedSize());
+	uint64_t stateSize = state->getSize();
+	memcpy(state->getData() + sizeAt, &stateSize, sizeof(stateSize));
+}
 
+bool GameBoy::restoreState(SaveState* state)
+{
+	return this->restoreStateInternal(state, false);
+}
 
+bool GameBoy::restoreStateInternal(SaveState* state, bool keepBattery)
+{
+	uint32_t magic, version;
+	uint64_t romHash, arenaSize, stateSize;
+	state->rewind();
+	bool ok = state->read(magic) && state->read(version);
+	ok = ok && state->read(romHash) && state->read(arenaSize) && state->read(stateSize);
+	//A state of another rom, cart ram size or a cut short file is turned away before anything is overwritten.
+	if(!ok || magic != SAVE_STATE_MAGIC || version != SAVE_STATE_VERSION)
+	{
+		return false;
+	}
+	if(romHash != this->romHash || arenaSize != this->arena.getUsedSize() || stateSize != state->getSize())
+	{
+		return false;
+	}
+	ok = state->read(this->cycleCount);
+	ok = ok && state->read(this->frameCount);
+	ok = ok && this->regFile.loadState(state);
+	ok = ok && this->intController.loadState(state);
+	ok = ok && this->mmu.loadState(state);
+	ok = ok && this->ioRam.loadState(state);
+	ok = ok && this->ppu.loadState(state);
+	if(!ok)
+	{
+		return false;
+	}
+	//Cart ram is the last region, leaving it out is just a shorter copy.
+	uint8_t* cartRam = this->arena.getRegion(GbArena::CART_RAM);
+	if(keepBattery && this->cart.hasBattery() && cartRam != nullptr)
+	{
+		arenaSize = (uint64_t)(cartRam - this->arena.getData());
+	}
+	//VRAM and OAM came in behind the tile cache's and the sprite lines' backs.
+	this->vram.markAllDirty();
+	uint64_t ramOffset = (cartRam != nullptr) ? (uint64_t)(cartRam - this->arena.getData()) : arenaSize;
+	if(ramOffset < arenaSize)
+	{
+		//Cart ram goes through the cartridge, a save file only flushes the pages that changed.
+		ok = state->readBlock(this->arena.getData(), ramOffset) && this->cart.loadRam(state, arenaSize - ramOffset);
+	}
+	else
+	{
+		ok = state->readBlock(this->arena.getData(), arenaSize);
+	}
+	this->oamRam.rebuildLines();
+	return ok;
+}
+
+bool GameBoy::loadRom(std::string romNamePath)
+{
+	//The rom is mapped, not copied. Another instance with the same rom already open makes this a lookup.
+	if(!this->cart.load(romNamePath))
+	{
+		return false;
+	}
+	//Boot mode is part of the key, a full boot start state sits at 0x0000 with the boot rom mapped.
+	this->romHash = StateHash::hash(this->cart.getRom(), this->cart.getRomSize(), 0);
+	uint64_t startStateKey = StateHash::hash((const uint8_t*)&this->romHash, sizeof(this->romHash), this->fastBoot ? 1 : 0);
+	this->hasStartState = false;
+	if(StartStateCache::lookup(startStateKey, &this->startState) && this->attachArena(this->cart.getRamSize()))
+	{
+		this->hasStartState = this->restoreStateInternal(&this->startState, false);
+	}
+	if(!this->hasStartState)
+	{
+		if(!this->reboot())
+		{
+			return false;
+		}
+		this->captureState(&this->startState);
+		StartStateCache::store(startStateKey, &this->startState);
+		this->hasStartState = true;
+	}
+	if(this->batteryFile && this->cart.hasBattery())
+	{
+		//Save lives next to the rom, game.gb -> game.sav.
+		size_t dot = romNamePath.find_last_of('.');
+		size_t slash = romNamePath.find_last_of('/');
+		if(dot != std::string::npos && (slash == std::string::npos || dot > slash))
+		{
+			romNamePath.erase(dot);
+		}
+		this->cart.openBattery(romNamePath + ".sav");
+		//Ram is now the file, its write window has to come off the fast path.
+		this->mmu.remap();
+	}
+	return true;
+}
 
+void GameBoy::run()
+{
+	this->running = true;
+	while(this->running && this->arenaReady)
+	{
+		this->runFrame();
+	}
+}
 
+void GameBoy::runFrame()
+{
+	if(!this->arenaReady)
+	{
+		return;
+	}
+	bool render = this->frameRequested || (this->renderInterval != 0 && (this->frameCount % this->renderInterval) == 0);
+	this->frameRequested = false;
+	if(this->runAheadFrames == 0)
+	{
+		this->emulateFrame(render);
+		return;
+	}
+	//Look ahead with the newest input, show the last frame reached, then step the real timeline by one.
+	this->captureState(&this->runAheadState);
+	for(uint8_t i = 1; i < this->runAheadFrames; i++)
+	{
+		this->emulateFrame(false);
+	}
+	this->emulateFrame(render);
+	this->restoreState(&this->runAheadState);
+	this->emulateFrame(false);
+}
 
+void GameBoy::setRenderInterval(uint32_t interval)
+{
+	this->renderInterval = interval;
+}
 
+void GameBoy::requestFrame()
+{
+	this->frameRequested = true;
+}
 
+void GameBoy::setInput(uint8_t buttons)
+{
+	this->ioRam.setJoypad(buttons);
+}
 
+uint8_t GameBoy::getInput()
+{
+	return this->ioRam.getJoypad();
+}
 
+void GameBoy::setRealTimeClock(bool hostTime)
+{
+	this->cart.setRealTimeClock(hostTime);
+}
 
+void GameBoy::setRunAhead(uint8_t frames)
+{
+	this->runAheadFrames = frames;
+}
 
+void GameBoy::emulateFrame(bool render)
+{
+	this->ppu.setRenderEnabled(render);
+	//Frames end at VBlank, so a host frame holds one whole PPU frame and run ahead presents the frame it rendered.
+	//With the LCD off there is no VBlank, a frame's worth of cycles stands in for it.
+	//Both depend only on machine state, a replay ends its frames on the same instructions.
+	uint64_t vblanks = this->ppu.getFrameCount();
+	uint64_t frameEnd = this->cycleCount + CYCLES_PER_FRAME;
+	while(this->ppu.getFrameCount() == vblanks && this->cycleCount < frameEnd)
+	{
+		this->step();
+	}
+	this->frameCount++;
+}
 
+uint64_t GameBoy::hashState()
+{
+	uint8_t regs[NUM_REG + 4];
+	for(int i = 0; i < NUM_REG; i++)
+	{
+		regs[i] = this->regFile.readReg((GbRegister::GbRegister)i);
+	}
+	uint16_t pc = this->regFile.readRegPair(GbRegister::PC);
+	uint16_t sp = this->regFile.readRegPair(GbRegister::SP);
+	regs[NUM_REG] = pc & 0x00FF;
+	regs[NUM_REG + 1] = (pc >> 8) & 0x00FF;
+	regs[NUM_REG + 2] = sp & 0x00FF;
+	regs[NUM_REG + 3] = (sp >> 8) & 0x00FF;
+	//Counters tick every frame whether or not the game did anything, leave them out.
+	uint8_t io[IO_REG_COUNT];
+	std::memcpy(io, this->ioRam.getData(), IO_REG_COUNT);
+	io[io_reg::DIV] = 0;
+	io[io_reg::TMIA] = 0;
+	io[io_reg::LY] = 0;
+	io[io_reg::STAT] &= 0xF8;
+	uint64_t hash = StateHash::hash(regs, sizeof(regs), 0);
+	hash = StateHash::hash(this->mmu.getInternalRam()->getData(), INTERNAL_RAM_SIZE, hash);
+	hash = StateHash::hash(this->mmu.getHRam()->getData(), HRAM_SIZE, hash);
+	return StateHash::hash(io, IO_REG_COUNT, hash);
+}
 
+std::string GameBoy::getFootprintReport()
+{
+	std::string report = "GameBoy object: " + std::to_string(sizeof(GameBoy)) + " bytes\n";
+	report += this->arena.getFootprintReport();
+	report += "Total: " + std::to_string(sizeof(GameBoy) + this->arena.getMappedSize()) + " bytes\n";
+	return report;
+}
 
+const uint8_t* GameBoy::getFramebuffer()
+{
+	return this->ppu.getFramebuffer();
+}
 
+FrameOutput* GameBoy::getFrameOutput()
+{
+	return this->ppu.getFrameOutput();
+}
 
+LineOutput* GameBoy::enableLineOutput(uint8_t linesPerPush)
+{
+	if(this->lineOutput == nullptr)
+	{
+		this->lineOutput = new LineOutput(linesPerPush);
+	}
+	else
+	{
+		this->lineOutput->setLinesPerPush(linesPerPush);
+	}
+	this->ppu.setLineOutput(this->lineOutput);
+	return this->lineOutput;
+}
+
+void GameBoy::disableLineOutput()
+{
+	this->ppu.setLineOutput(nullptr);
+}
+
+uint64_t GameBoy::getCycleCount()
+{
+	return this->cycleCount;
+}
+
+uint64_t GameBoy::getFrameCount()
+{
+	return this->frameCount;
+}
+
+bool GameBoy::reboot()
+{
+	if(!this->attachArena(this->cart.getRamSize()))
+	{
+		return false;
+	}
+	this->regFile.writeRegPair(GbRegister::AF, 0x0000);
+	this->regFile.writeRegPair(GbRegister::BC, 0x0000);
+	this->regFile.writeRegPair(GbRegister::DE, 0x0000);
+	this->regFile.writeRegPair(GbRegister::HL, 0x0000);
+	this->regFile.writeRegPair(GbRegister::SP, 0x0000);
+	this->regFile.writeRegPair(GbRegister::PC, 0x0000);
+	//The clock is battery backed, take its time while the counter still holds it. The cart reset below re-anchors it on zero.
+	this->cart.rebaseClock();
+	this->cycleCount = 0;
+	this->frameCount = 0;
+	this->intController.reset();
+	this->mmu.reset();
+	this->ppu.reset();
+	if(this->fastBoot)
+	{
+		this->mmu.fastBoot();
+		this->regFile.writeRegPair(GbRegister::AF, this->mmu.getPostBootAF());
+		this->regFile.writeRegPair(GbRegister::BC, 0x0013);
+		this->regFile.writeRegPair(GbRegister::DE, 0x00D8);
+		this->regFile.writeRegPair(GbRegister::HL, 0x014D);
+		this->regFile.writeRegPair(GbRegister::SP, 0xFFFE);
+		this->regFile.writeRegPair(GbRegister::PC, POST_BOOT_PC);
+	}
+	return true;
+}
+
+void GameBoy::setFastBoot(bool enabled)
+{
+	this->fastBoot = enabled;
+}
+
+void GameBoy::setBatteryFile(bool enabled)
+{
+	this->batteryFile = enabled;
+}
+
+void GameBoy::reset()
+{
+	if(!this->hasStartState)
+	{
+		this->reboot();
+		return;
+	}
+	bool timer = this->cart.hasTimer();
+	if(timer)
+	{
+		this->clockState.clear();
+		this->cart.saveClock(&this->clockState);
+	}
+	if(!this->restoreStateInternal(&this->startState, true))
+	{
+		this->reboot();
+	}
+	if(timer)
+	{
+		this->clockState.rewind();
+		this->cart.loadClock(&this->clockState);
+	}
+}
+
+void GameBoy::restoreStartState()
+{
+	//Cart ram is the file mapping, restoring over it would overwrite the save on disk.
+	if(this->cart.isBatteryOpen())
+	{
+		this->reset();
+		return;
+	}
+	if(!this->hasStartState || !this->restoreStateInternal(&this->startState, false))
+	{
+		this->reboot();
+	}
+}
+
+void GameBoy::detachBattery()
+{
+	this->cart.detachBattery();
+	//Ram writes no longer need dirty tracking, put the window back on the fast path.
+	this->mmu.remap();
+}
+
+void GameBoy::forgetBattery()
+{
+	this->cart.forgetBattery();
+	this->mmu.remap();
+}
+
+void GameBoy::setStartState()
+{
+	this->captureState(&this->startState);
+	this->hasStartState = true;
+}
+
+bool GameBoy::verifyFastBoot(std::string* report)
+{
+	bool configured = this->fastBoot;
+	std::vector<uint8_t> full;
+	std::vector<uint8_t> fast;
+	std::ostringstream out;
+
+	this->fastBoot = false;
+	if(!this->reboot())
+	{
+		this->fastBoot = configured;
+		if(report != nullptr)
+		{
+			*report = "Emulated memory could not be mapped\n";
+		}
+		return false;
+	}
+	while(this->mmu.isBootRomMapped() && this->cycleCount < FAST_BOOT_VERIFY_CYCLES)
+	{
+		this->step();
+	}
+	bool booted = !this->mmu.isBootRomMapped() && this->regFile.readRegPair(GbRegister::PC) == POST_BOOT_PC;
+	if(!booted)
+	{
+		out << "Full boot did not reach 0x0100 (bad logo or checksum locks the boot rom)\n";
+	}
+	this->snapshotPostBoot(&full);
+
+	this->fastBoot = true;
+	this->reboot();
+	this->snapshotPostBoot(&fast);
+
+	static const char* regNames[6] = {"AF", "BC", "DE", "HL", "SP", "PC"};
+	int mismatches = 0;
+	for(size_t i = 0; i < full.size(); i++)
+	{
+		if(full[i] == fast[i])
+		{
+			continue;
+		}
+		mismatches++;
+		if(mismatches > 16)
+		{
+			continue;
+		}
+		out << std::hex;
+		if(i < 12)
+		{
+			out << regNames[i / 2] << (i % 2 == 0 ? " high" : " low");
+		}
+		else
+		{
+			out << "0x" << (0x8000 + i - 12);
+		}
+		out << ": full 0x" << (int)full[i] << " fast 0x" << (int)fast[i] << std::dec << "\n";
+	}
+	out << mismatches << " mismatches, DIV IF STAT LY NR52 not compared\n";
+	if(report != nullptr)
+	{
+		*report = out.str();
+	}
+
+	this->fastBoot = configured;
+	this->reboot();
+	return booted && mismatches == 0;
+}
+
+bool GameBoy::verifyRunAhead(uint32_t frames, std::string* report)
+{
+	std::ostringstream out;
+	uint8_t ahead = this->runAheadFrames;
+	if(ahead == 0 || frames == 0 || !this->arenaReady)
+	{
+		out << (this->arenaReady ? "Run ahead is off, nothing to compare\n" : "Emulated memory could not be mapped\n");
+		if(report != nullptr)
+		{
+			*report = out.str();
+		}
+		return false;
+	}
+	uint32_t interval = this->renderInterval;
+	bool requested = this->frameRequested;
+	//Start on a frame boundary so both runs draw their first frame whole.
+	this->emulateFrame(false);
+	SaveState start;
+	this->captureState(&start);
+
+	//The plain timeline, every frame kept.
+	size_t pixels = PPU_SCREEN_WIDTH * PPU_SCREEN_HEIGHT;
+	std::vector<uint8_t> plain((frames + ahead) * pixels);
+	for(uint32_t i = 0; i < frames + ahead; i++)
+	{
+		this->emulateFrame(true);
+		memcpy(plain.data() + i * pixels, this->ppu.getFramebuffer(), pixels);
+	}
+
+	this->restoreState(&start);
+	this->renderInterval = 1;
+	int mismatches = 0;
+	for(uint32_t i = 0; i < frames; i++)
+	{
+		this->runFrame();
+		const uint8_t* expected = plain.data() + (i + ahead - 1) * pixels;
+		const uint8_t* presented = this->ppu.getFramebuffer();
+		size_t differing = 0;
+		for(size_t p = 0; p < pixels; p++)
+		{
+			differing += (presented[p] != expected[p]) ? 1 : 0;
+		}
+		if(differing != 0)
+		{
+			mismatches++;
+			out << "Host frame " << i << ": " << differing << " pixels differ from plain frame " << (i + ahead - 1) << "\n";
+		}
+	}
+	out << mismatches << " of " << frames << " presented frames mismatched at " << (int)ahead << " frames ahead\n";
+	if(report != nullptr)
+	{
+		*report = out.str();
+	}
+
+	this->restoreState(&start);
+	this->renderInterval = interval;
+	this->frameRequested = requested;
+	return mismatches == 0;
+}
+
+void GameBoy::snapshotPostBoot(std::vector<uint8_t>* out)
+{
+	out->clear();
+	static const GbRegister::GbRegister pairs[6] = {GbRegister::AF, GbRegister::BC, GbRegister::DE, GbRegister::HL, GbRegister::SP, GbRegister::PC};
+	for(int i = 0; i < 6; i++)
+	{
+		uint16_t value = this->regFile.readRegPair(pairs[i]);
+		out->push_back((value >> 8) & 0x00FF);
+		out->push_back(value & 0x00FF);
+	}
+	for(uint32_t address = 0x8000; address <= 0xFFFF; address++)
+	{
+		out->push_back(this->mmu.read((uint16_t)address));
+	}
+	//Owned by the timer, PPU and APU, which don't run cycle exact through the boot animation yet.
+	static const uint8_t skipped[5] = {io_reg::DIV, io_reg::IF, io_reg::STAT, io_reg::LY, io_reg::NR52};
+	for(int i = 0; i < 5; i++)
+	{
+		(*out)[12 + 0x7F00 + skipped[i]] = 0;
+	}
+}
+
+bool GameBoy::attachArena(size_t cartRamSize)
+{
+	//On failure the regions come back null, nothing is left pointing into the released mapping.
+	this->arenaReady = this->arena.allocate(cartRamSize, this->useHugePages);
+	this->mmu.getInternalRam()->attach(this->arena.getRegion(GbArena::WRAM));
+	this->mmu.getHRam()->attach(this->arena.getRegion(GbArena::HRAM));
+	this->ioRam.attach(this->arena.getRegion(GbArena::IO_RAM));
+	this->oamRam.attach(this->arena.getRegion(GbArena::OAM));
+	this->vram.attach(this->arena.getRegion(GbArena::VRAM));
+	this->cart.attachRam(this->arena.getRegion(GbArena::CART_RAM));
+	this->mmu.remap();
+	return this->arenaReady;
+}
+
+void GameBoy::step()
+{
+	uint16_t pc = this->regFile.readRegPair(GbRegister::PC);
+	uint8_t instBytes[3] = { this->mmu.read(pc), this->mmu.read(pc + 1), this->mmu.read(pc + 2) };
+	uint8_t pcInc = 0;
+	this->execute.executeInstruction(instBytes, pcInc);
+	this->intController.getNextPC();
+	uint8_t cycles = this->cycleListener.getNumCycles();
+	this->cycleCount += cycles;
+	this->mmu.tick();
+	this->ppu.tick(cycles);
+}
 
 /*
-<++> CHANGE::<++>()
+<++> GameBoy::<++>()
 {
 
 }
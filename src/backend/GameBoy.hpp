@@ -2,7 +2,7 @@
  *Class - GameBoy
  *Author - Zach Walden
  *Created - 7/22/22
- *Last Changed - 10/11/23
+ *Last Changed - 10/19/26
  *Description - Top Level GameBoy Module/Class
 ====================================================================================*/
 
@@ -29,7 +29,32 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#pragma once
+
 #include <string>
+#include <vector>
+#include <cstdint>
+
+#include "MemoryArena/MemoryArena.hpp"
+#include "Cartridge/Cartridge.hpp"
+#include "PPU/VRAM/VRAM.hpp"
+#include "PPU/OamRam/OamRam.hpp"
+#include "IoRam/IoRam.hpp"
+#include "CPU/MMU/MMU.hpp"
+#include "CPU/Execute/RegisterFile/RegisterFile.hpp"
+#include "CycleListener/CycleListener.hpp"
+#include "CPU/InterruptController/InterruptController.hpp"
+#include "CPU/Execute/Execute.hpp"
+#include "PPU/PPU.hpp"
+#include "PPU/FrameConverter/FrameConverter.hpp"
+#include "SaveState/SaveState.hpp"
+#include "StateHash/StateHash.hpp"
+#include "StartStateCache/StartStateCache.hpp"
+
+//154 lines * 456 dots
+#define CYCLES_PER_FRAME 70224
+//Full boot gives up after this many cycles, the animation takes a few seconds and a bad logo locks it forever.
+#define FAST_BOOT_VERIFY_CYCLES (60ULL * 4194304)
 
 class GameBoy
 {
@@ -37,23 +62,127 @@ class GameBoy
 public:
 
 private:
-	void* frameDumpCallback;
+	//All mutable emulated memory, the memory classes below point into it.
+	MemoryArena arena;
+	bool useHugePages = false;
+	//False when the arena could not be mapped. Nothing runs until a loadRom maps it.
+	bool arenaReady = false;
+	//Hardware. Declared in construction order, the MMU and CPU hold pointers to the memories above them.
+	Cartridge cart;
+	VRAM vram;
+	IoRam ioRam;
+	OamRam oamRam;
+	MMU mmu;
+	RegisterFile regFile;
+	CycleListener cycleListener;
+	InterruptController intController;
+	Execute execute;
+	PPU ppu;
+	//Master clock, T-cycles since power on.
+	uint64_t cycleCount = 0;
+	uint64_t frameCount = 0;
+	bool running = false;
+	//Scratch state for the file save/load path.
+	SaveState fileState;
+	//Frames emulated ahead of the real timeline each host frame, 0 = off.
+	uint8_t runAheadFrames = 0;
+	SaveState runAheadState;
+	//Skip the boot rom and start at 0x0100 with its post boot state.
+	bool fastBoot = false;
+	//Map battery ram over the rom's .sav on load. Off keeps it in memory only.
+	bool batteryFile = true;
+	//This rom's start state, copied out of the StartStateCache on load so a reset never takes the cache lock.
+	//setStartState replaces this copy only, the cache keeps the post boot state every loadRom starts from.
+	SaveState startState;
+	//Identifies the rom in save states, a state only restores onto the rom it was taken from.
+	uint64_t romHash = 0;
+	bool hasStartState = false;
+	//Compose every Nth frame, 0 = only frames asked for with requestFrame. Timing and interrupts run either way.
+	uint32_t renderInterval = 1;
+	bool frameRequested = false;
+	//Battery backed state carried across a reset.
+	SaveState clockState;
+	//Created on first use, kept until the GameBoy goes so a consumer never sees it freed.
+	LineOutput* lineOutput = nullptr;
 	//Methods
 public:
 	GameBoy();
+	GameBoy(bool useHugePages);
 	~GameBoy();
 
-	void setCallback(void* frameDumpCallback);
+	//False when the emulated memory could not be mapped, the instance can't run.
+	bool isReady();
 
 	//emulator goodies. will be useful for debugging as well.
-	void saveState(std::string saveStateNamePath);
-	void loadState(std::string saveStateNamePath);
+	bool saveState(std::string saveStateNamePath);
+	bool loadState(std::string saveStateNamePath);
+	//In memory save states. Capturing into the same SaveState again does not allocate.
+	void captureState(SaveState* state);
+	bool restoreState(SaveState* state);
 
 	//resets the core and restarts with boot process.
-	void loadRom(std::string romNamePath);
+	bool loadRom(std::string romNamePath);
+	//Takes effect on the next loadRom or reboot.
+	void setFastBoot(bool enabled);
+	//Takes effect on the next loadRom. Off for instances that must not share the save file with each other.
+	void setBatteryFile(bool enabled);
+	//Back to the rom's start state, a state load rather than a boot. Battery ram and the clock carry over as on hardware.
+	void reset();
+	//Back to the start state exactly, battery ram and the clock included. Nothing of the previous run is left.
+	//With a save file open this is reset(), battery ram and the clock are the file's and stay as they are.
+	void restoreStartState();
+	//Makes the current state this instance's start state for reset, until the next loadRom.
+	void setStartState();
+	//Cart ram becomes private, nothing the instance does from here reaches the save file.
+	void detachBattery();
+	//detachBattery for a forked child, safe while another thread of the parent held the battery flusher at fork.
+	void forgetBattery();
+	//Runs the real boot rom, then a fast boot, and compares registers and 0x8000-0xFFFF at 0x0100. Mismatches go to report.
+	//Leaves the core rebooted in the configured mode.
+	bool verifyFastBoot(std::string* report);
+	//Runs frames host frames with run ahead on, then again from the same state without it, and checks every presented frame
+	//against the frame the plain run reached runAheadFrames later. Mismatches go to report. Leaves the core where it started.
+	bool verifyRunAhead(uint32_t frames, std::string* report);
 
 	void run();
+	//Runs one host frame. With run ahead on, the frame presented is runAheadFrames ahead of the real timeline.
+	void runFrame();
+
+	void setInput(uint8_t buttons);
+	uint8_t getInput();
+	//MBC3 clock on the host's wall clock. Off by default so the clock replays with states and movies.
+	void setRealTimeClock(bool hostTime);
+	//For jobs that mostly read RAM. 1 renders every frame, N every Nth, 0 only frames asked for with requestFrame.
+	void setRenderInterval(uint32_t interval);
+	//The next runFrame composes its frame whatever the interval says.
+	void requestFrame();
+	//Hides the game's own input lag. Costs frames + 1 emulated frames, a state save and a load per host frame.
+	void setRunAhead(uint8_t frames);
+
+	//Fingerprint of the game visible state, registers, WRAM, HRAM and the IO registers that are not free running counters.
+	uint64_t hashState();
+
+	//Bytes this instance costs, the object itself plus its arena.
+	std::string getFootprintReport();
+
+	//Last completed frame, shades 0-3 at PPU_SCREEN_WIDTH * PPU_SCREEN_HEIGHT. Only for the thread running the GameBoy.
+	const uint8_t* getFramebuffer();
+	//Frames for another thread (UI, encoder, RL client), latest frame with no copy and no tearing.
+	//A FrameConverter per consumer turns them into its pixel format.
+	FrameOutput* getFrameOutput();
+	//Lines as they are drawn, for displays that race the beam. Pushed linesPerPush at a time and at every VBlank.
+	LineOutput* enableLineOutput(uint8_t linesPerPush);
+	//The queue stays allocated, the consumer can drain what is left.
+	void disableLineOutput();
+	uint64_t getCycleCount();
+	uint64_t getFrameCount();
 
 private:
-	void reboot();
+	bool reboot();
+	bool restoreStateInternal(SaveState* state, bool keepBattery);
+	void snapshotPostBoot(std::vector<uint8_t>* out);
+	bool attachArena(size_t cartRamSize);
+	void step();
+	//Runs to the next VBlank, or for one frame's worth of cycles while the LCD is off.
+	void emulateFrame(bool render);
 };
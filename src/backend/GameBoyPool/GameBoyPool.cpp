@@ -0,0 +1,175 @@
+/*==================================================================================
+ *Class - GameBoyPool
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Fixed set of GameBoys constructed once in one slab. Lock free acquire/release, release restores the instance to its rom's start state.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <new>
+#include <sys/mman.h>
+
+#include "GameBoyPool.hpp"
+
+GameBoyPool::GameBoyPool(uint32_t count, bool useHugePages) : freeHead(POOL_NO_SLOT), available(0)
+{
+	this->slotSize = (sizeof(GameBoy) + POOL_SLOT_ALIGN - 1) & ~(size_t)(POOL_SLOT_ALIGN - 1);
+	this->slabSize = this->slotSize * count;
+	void* memory = mmap(nullptr, this->slabSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(memory == MAP_FAILED)
+	{
+		return;
+	}
+	this->slab = (uint8_t*)memory;
+	this->count = count;
+	this->next = new std::atomic<uint32_t>[count];
+	bool ready = true;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		GameBoy* gameBoy = new (this->slab + i * this->slotSize) GameBoy(useHugePages);
+		ready = ready && gameBoy->isReady();
+	}
+	//A pool with instances that can't run is no pool, hand out none.
+	if(!ready)
+	{
+		for(uint32_t i = 0; i < count; i++)
+		{
+			this->slot(i)->~GameBoy();
+		}
+		munmap(this->slab, this->slabSize);
+		this->slab = nullptr;
+		this->count = 0;
+		return;
+	}
+	//Pushed in reverse so slot 0 is handed out first.
+	for(uint32_t i = count; i > 0; i--)
+	{
+		this->push(i - 1);
+	}
+}
+
+GameBoyPool::~GameBoyPool()
+{
+	for(uint32_t i = 0; i < this->count; i++)
+	{
+		this->slot(i)->~GameBoy();
+	}
+	if(this->slab != nullptr)
+	{
+		munmap(this->slab, this->slabSize);
+	}
+	delete[] this->next;
+}
+
+bool GameBoyPool::loadRom(std::string romNamePath, bool fastBoot)
+{
+	for(uint32_t i = 0; i < this->count; i++)
+	{
+		this->slot(i)->setFastBoot(fastBoot);
+		//One .sav mapped shared under every instance would leak each run's ram into the others.
+		this->slot(i)->setBatteryFile(false);
+		if(!this->slot(i)->loadRom(romNamePath))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+GameBoy* GameBoyPool::acquire()
+{
+	uint32_t index = this->pop();
+	if(index == POOL_NO_SLOT)
+	{
+		return nullptr;
+	}
+	return this->slot(index);
+}
+
+void GameBoyPool::release(GameBoy* gameBoy)
+{
+	uint32_t index = (uint32_t)(((uint8_t*)gameBoy - this->slab) / this->slotSize);
+	gameBoy->restoreStartState();
+	this->push(index);
+}
+
+uint32_t GameBoyPool::getCount()
+{
+	return this->count;
+}
+
+uint32_t GameBoyPool::getAvailable()
+{
+	return this->available.load(std::memory_order_relaxed);
+}
+
+GameBoy* GameBoyPool::slot(uint32_t index)
+{
+	return (GameBoy*)(this->slab + index * this->slotSize);
+}
+
+void GameBoyPool::push(uint32_t index)
+{
+	uint64_t head = this->freeHead.load(std::memory_order_relaxed);
+	uint64_t newHead;
+	do
+	{
+		this->next[index].store((uint32_t)head, std::memory_order_relaxed);
+		newHead = (head & 0xFFFFFFFF00000000ULL) | index;
+	}
+	while(!this->freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+	this->available.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t GameBoyPool::pop()
+{
+	uint64_t head = this->freeHead.load(std::memory_order_acquire);
+	uint64_t newHead;
+	do
+	{
+		uint32_t index = (uint32_t)head;
+		if(index == POOL_NO_SLOT)
+		{
+			return POOL_NO_SLOT;
+		}
+		//next[] may be stale if another thread popped and pushed this slot meanwhile, the tag makes that CAS fail.
+		uint32_t following = this->next[index].load(std::memory_order_relaxed);
+		newHead = ((head + 0x100000000ULL) & 0xFFFFFFFF00000000ULL) | following;
+	}
+	while(!this->freeHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire));
+	this->available.fetch_sub(1, std::memory_order_relaxed);
+	return (uint32_t)head;
+}
+
+/*
+<++> GameBoyPool::<++>()
+{
+
+}
+*/
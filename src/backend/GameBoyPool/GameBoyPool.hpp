@@ -0,0 +1,83 @@
+/*==================================================================================
+ *Class - GameBoyPool
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Fixed set of GameBoys constructed once in one slab. Lock free acquire/release, release restores the instance to its rom's start state.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "../GameBoy.hpp"
+
+//Slots start on a cache line so neighbouring instances never share one.
+#define POOL_SLOT_ALIGN 64
+//Free list end marker.
+#define POOL_NO_SLOT 0xFFFFFFFF
+
+class GameBoyPool
+{
+	//Attributes
+public:
+
+private:
+	uint8_t* slab = nullptr;
+	size_t slabSize = 0;
+	size_t slotSize = 0;
+	uint32_t count = 0;
+	//Treiber stack of free slots. Low 32 bits are the top slot, high 32 bits a tag bumped on every pop so a stale CAS fails (ABA).
+	std::atomic<uint64_t> freeHead;
+	std::atomic<uint32_t>* next = nullptr;
+	std::atomic<uint32_t> available;
+	//Methods
+public:
+	//getCount() is 0 when the slab or any instance's memory could not be mapped.
+	GameBoyPool(uint32_t count, bool useHugePages);
+	~GameBoyPool();
+
+	//Loads the rom into every instance, which also fills the start state cache once for all of them.
+	//Battery ram stays in each instance's memory, the .sav is not opened.
+	//Not safe against concurrent acquire, call it before handing the pool out.
+	bool loadRom(std::string romNamePath, bool fastBoot);
+
+	//nullptr when every instance is out.
+	GameBoy* acquire();
+	//Restores the instance to the start state, cart ram included, and returns it to the pool.
+	void release(GameBoy* gameBoy);
+
+	uint32_t getCount();
+	uint32_t getAvailable();
+private:
+	GameBoy* slot(uint32_t index);
+	void push(uint32_t index);
+	uint32_t pop();
+};
@@ -1,9 +1,9 @@
 /*==================================================================================
  *Class - IoRam
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - I/O Registers.
 ====================================================================================*/
 
 /*
@@ -33,23 +33,160 @@
 
 #include "IoRam.hpp"
 
+//DMG read masks, the bits of each register that have no storage and read back as 1.
+static const uint8_t ioReadOr[IO_REG_COUNT] =
+{
+	0xC0, 0x00, 0x7E, 0xFF, 0x00, 0x00, 0x00, 0xF8, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0,
+	0x80, 0x3F, 0x00, 0xFF, 0xBF, 0xFF, 0x3F, 0x00, 0xFF, 0xBF, 0x7F, 0xFF, 0x9F, 0xFF, 0xBF, 0xFF,
+	0xFF, 0x00, 0x00, 0xBF, 0x00, 0x00, 0x70, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x00
+};
+
+IoRam::IoRam()
+{
+	for(int i = 0; i < IO_REG_COUNT; i++)
+	{
+		this->handlers[i].read = nullptr;
+		this->handlers[i].write = nullptr;
+		this->handlers[i].instance = nullptr;
+		this->handlers[i].readOr = ioReadOr[i];
+		//Registers that read back all ones have nothing to store.
+		this->handlers[i].writeMask = (ioReadOr[i] == 0xFF) ? 0x00 : 0xFF;
+	}
+	this->handlers[io_reg::P1JOYP].writeMask = 0x30;
+	this->handlers[io_reg::IF].writeMask = 0x1F;
+	this->handlers[io_reg::NR52].writeMask = 0x80;
+	this->handlers[io_reg::STAT].writeMask = 0x78;
+	this->handlers[io_reg::LY].writeMask = 0x00;
+	this->registerHandler(io_reg::P1JOYP, &IoRam::readJoypad, nullptr, this);
+	this->registerHandler(io_reg::DIV, nullptr, &IoRam::writeDiv, this);
+	this->registerHandler(io_reg::NR52, nullptr, &IoRam::writeNr52, this);
+}
 
+IoRam::~IoRam()
+{
 
+}
 
+uint8_t IoRam::read(uint16_t addr)
+{
+	uint8_t reg = regIndex(addr);
+	IoHandler& handler = this->handlers[reg];
+	uint8_t value = (handler.read != nullptr) ? handler.read(handler.instance, reg) : this->regs[reg];
+	return value | handler.readOr;
+}
 
+void IoRam::write(uint16_t addr, uint8_t value)
+{
+	uint8_t reg = regIndex(addr);
+	IoHandler& handler = this->handlers[reg];
+	uint8_t oldValue = this->regs[reg];
+	this->regs[reg] = (oldValue & ~handler.writeMask) | (value & handler.writeMask);
+	if(handler.write != nullptr)
+	{
+		handler.write(handler.instance, reg, oldValue, value);
+	}
+}
 
+uint8_t IoRam::peek(uint16_t addr)
+{
+	uint8_t reg = regIndex(addr);
+	return this->regs[reg] | this->handlers[reg].readOr;
+}
 
+void IoRam::poke(uint16_t addr, uint8_t value)
+{
+	this->regs[regIndex(addr)] = value;
+}
 
+void IoRam::registerHandler(uint8_t reg, uint8_t (*read)(void*, uint8_t), void (*write)(void*, uint8_t, uint8_t, uint8_t), void* instance)
+{
+	this->handlers[reg].read = read;
+	this->handlers[reg].write = write;
+	this->handlers[reg].instance = instance;
+}
 
+uint8_t IoRam::regIndex(uint16_t addr)
+{
+	return (addr == 0xFFFF) ? IO_REG_IE_INDEX : (addr & 0x007F);
+}
 
+uint8_t IoRam::readJoypad(void* instance, uint8_t reg)
+{
+	IoRam* io = (IoRam*)instance;
+	//Rows are selected by writing 0, a pressed button reads as 0.
+	uint8_t select = io->regs[reg] & 0x30;
+	uint8_t lines = 0x0F;
+	if((select & 0x10) == 0)
+	{
+		lines &= ~(io->joypad & 0x0F);
+	}
+	if((select & 0x20) == 0)
+	{
+		lines &= ~((io->joypad >> 4) & 0x0F);
+	}
+	return select | lines;
+}
 
+void IoRam::writeDiv(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue)
+{
+	//Any write clears the divider.
+	((IoRam*)instance)->regs[reg] = 0;
+}
 
+void IoRam::writeNr52(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue)
+{
+	//Powering the APU off clears every sound register, wave ram is untouched.
+	if((newValue & 0x80) == 0)
+	{
+		IoRam* io = (IoRam*)instance;
+		for(uint8_t i = io_reg::NR10; i < io_reg::NR52; i++)
+		{
+			io->regs[i] = 0;
+		}
+	}
+}
 
+void IoRam::setJoypad(uint8_t buttons)
+{
+	uint8_t released = ~this->joypad;
+	this->joypad = buttons;
+	//Joypad interrupt on any newly pressed button.
+	if((buttons & released) != 0)
+	{
+		this->regs[io_reg::IF] |= 0x10;
+	}
+}
 
+uint8_t IoRam::getJoypad()
+{
+	return this->joypad;
+}
 
+void IoRam::attach(uint8_t* memory)
+{
+	this->regs = memory;
+}
 
+uint8_t* IoRam::getData()
+{
+	return this->regs;
+}
 
+void IoRam::saveState(SaveState* state)
+{
+	state->write(this->joypad);
+}
 
+bool IoRam::loadState(SaveState* state)
+{
+	return state->read(this->joypad);
+}
 
 /*
 <++> IoRam::<++>()
@@ -2,7 +2,7 @@
  *Class - IoRam
  *Author - Zach Walden
  *Created - 2/19/24
- *Last Changed - 2/19/24
+ *Last Changed - 10/19/26
  *Description - I/O Registers.
 ====================================================================================*/
 
@@ -29,8 +29,18 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#pragma once
+
 //$FF00 -> FF7F
 #include <cstdint>
+
+#include "../SaveState/SaveState.hpp"
+
+#define IO_RAM_SIZE 128
+//IE (0xFFFF) is kept after the 128 IO registers so every register goes through the one table.
+#define IO_REG_IE_INDEX 128
+#define IO_REG_COUNT 129
+
 namespace io_reg
 {
 	enum IoReg
@@ -107,20 +117,71 @@ namespace io_reg
 	};
 };
 
+namespace GbButton
+{
+	//Bit set = pressed. Low nibble is the direction row of P1, high nibble the button row.
+	enum GbButton
+	{
+		RIGHT = 0x01,
+		LEFT = 0x02,
+		UP = 0x04,
+		DOWN = 0x08,
+		A = 0x10,
+		B = 0x20,
+		SELECT = 0x40,
+		START = 0x80
+	};
+};
+
+//Per register dispatch entry. No read handler means the stored byte is returned, no write handler means the write is only stored.
+struct IoHandler
+{
+	uint8_t (*read)(void* instance, uint8_t reg);
+	//Called after the masked value is stored, with the previous contents and the value as written.
+	void (*write)(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue);
+	void* instance;
+	//Bits that always read as 1 (unused bits, unmapped registers).
+	uint8_t readOr;
+	//Bits a write may change.
+	uint8_t writeMask;
+};
+
 class IoRam
 {
 	//Attributes
 public:
 
 private:
+	uint8_t* regs = nullptr;
+	uint8_t joypad = 0;
+	IoHandler handlers[IO_REG_COUNT];
 	//Methods
 public:
 	IoRam();
 	~IoRam();
 
+	//0xFF00-0xFF7F and 0xFFFF.
 	uint8_t read(uint16_t addr);
 	void write(uint16_t addr, uint8_t value);
+	//Stored register bytes, no handlers run. For debuggers and tools that must not disturb the machine.
+	uint8_t peek(uint16_t addr);
+	void poke(uint16_t addr, uint8_t value);
+
+	//Components hook the registers they own, the instance is handed back to the handler.
+	void registerHandler(uint8_t reg, uint8_t (*read)(void*, uint8_t), void (*write)(void*, uint8_t, uint8_t, uint8_t), void* instance);
+
+	void attach(uint8_t* memory);
+	uint8_t* getData();
+
+	void setJoypad(uint8_t buttons);
+	uint8_t getJoypad();
 
+	//Register contents are saved with the arena, this is the state kept outside it.
+	void saveState(SaveState* state);
+	bool loadState(SaveState* state);
 private:
-	uint8_t readReg(uint8_t reg);
+	static uint8_t regIndex(uint16_t addr);
+	static uint8_t readJoypad(void* instance, uint8_t reg);
+	static void writeDiv(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue);
+	static void writeNr52(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue);
 };
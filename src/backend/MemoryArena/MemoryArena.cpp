@@ -0,0 +1,179 @@
+/*==================================================================================
+ *Class - MemoryArena
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - One aligned block per GameBoy holding every byte of mutable emulated memory. Memories get pointers into it, so a snapshot of all of them is one memcpy.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include "MemoryArena.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <sstream>
+
+#include "../CPU/MMU/InternalRam/InternalRam.hpp"
+#include "../CPU/MMU/HRam/HRam.hpp"
+#include "../IoRam/IoRam.hpp"
+#include "../PPU/OamRam/OamRam.hpp"
+#include "../PPU/VRAM/VRAM.hpp"
+
+static const char* arenaRegionNames[GbArena::NUM_REGIONS] = {
+	"WRAM", "HRAM", "IO", "OAM", "VRAM", "CART RAM"
+};
+
+MemoryArena::MemoryArena()
+{
+
+}
+
+MemoryArena::~MemoryArena()
+{
+	this->release();
+}
+
+bool MemoryArena::allocate(size_t cartRamSize, bool useHugePages)
+{
+	//Same layout as before, a reboot only needs the memory cleared. Cart ram is left to the cartridge, it may be a battery file.
+	if(this->base != nullptr && this->sizes[GbArena::CART_RAM] == cartRamSize && (this->hugePages || !useHugePages))
+	{
+		std::memset(this->base, 0, this->offsets[GbArena::CART_RAM]);
+		return true;
+	}
+	this->release();
+	this->sizes[GbArena::WRAM] = INTERNAL_RAM_SIZE;
+	this->sizes[GbArena::HRAM] = HRAM_SIZE;
+	this->sizes[GbArena::IO_RAM] = IO_REG_COUNT;
+	this->sizes[GbArena::OAM] = OAM_RAM_SIZE;
+	this->sizes[GbArena::VRAM] = VRAM_SIZE;
+	this->sizes[GbArena::CART_RAM] = cartRamSize;
+	size_t offset = 0;
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	for(int i = 0; i < GbArena::NUM_REGIONS; i++)
+	{
+		//Cart ram gets whole pages so a save file can be mapped straight over it.
+		if(i == GbArena::CART_RAM)
+		{
+			offset = (offset + pageSize - 1) & ~(pageSize - 1);
+		}
+		this->offsets[i] = offset;
+		offset += (this->sizes[i] + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+	}
+	this->usedSize = offset;
+
+	void* memory = MAP_FAILED;
+	if(useHugePages)
+	{
+		size_t hugeSize = (this->usedSize + ARENA_HUGE_PAGE_SIZE - 1) & ~(size_t)(ARENA_HUGE_PAGE_SIZE - 1);
+		memory = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if(memory != MAP_FAILED)
+		{
+			this->mappedSize = hugeSize;
+			this->hugePages = true;
+		}
+	}
+	if(memory == MAP_FAILED)
+	{
+		size_t pagedSize = (this->usedSize + pageSize - 1) & ~(pageSize - 1);
+		memory = mmap(nullptr, pagedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(memory == MAP_FAILED)
+		{
+			return false;
+		}
+		this->mappedSize = pagedSize;
+		this->hugePages = false;
+	}
+	this->base = (uint8_t*)memory;
+	return true;
+}
+
+void MemoryArena::release()
+{
+	if(this->base != nullptr)
+	{
+		munmap(this->base, this->mappedSize);
+		this->base = nullptr;
+	}
+	this->mappedSize = 0;
+	this->usedSize = 0;
+	this->hugePages = false;
+}
+
+uint8_t* MemoryArena::getRegion(GbArena::Region region)
+{
+	if(this->base == nullptr || this->sizes[region] == 0)
+	{
+		return nullptr;
+	}
+	return this->base + this->offsets[region];
+}
+
+size_t MemoryArena::getRegionSize(GbArena::Region region)
+{
+	return this->sizes[region];
+}
+
+uint8_t* MemoryArena::getData()
+{
+	return this->base;
+}
+
+size_t MemoryArena::getUsedSize()
+{
+	return this->usedSize;
+}
+
+size_t MemoryArena::getMappedSize()
+{
+	return this->mappedSize;
+}
+
+bool MemoryArena::usesHugePages()
+{
+	return this->hugePages;
+}
+
+std::string MemoryArena::getFootprintReport()
+{
+	std::ostringstream report;
+	for(int i = 0; i < GbArena::NUM_REGIONS; i++)
+	{
+		report << arenaRegionNames[i] << ": " << this->sizes[i] << " bytes @ +" << this->offsets[i] << "\n";
+	}
+	report << "Arena used: " << this->usedSize << " bytes, mapped: " << this->mappedSize << " bytes";
+	report << (this->hugePages ? " (huge pages)" : "") << "\n";
+	return report.str();
+}
+
+/*
+<++> MemoryArena::<++>()
+{
+
+}
+*/
@@ -0,0 +1,88 @@
+/*==================================================================================
+ *Class - MemoryArena
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - One aligned block per GameBoy holding every byte of mutable emulated memory. Memories get pointers into it, so a snapshot of all of them is one memcpy.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+//Regions start on a cache line.
+#define ARENA_ALIGN 64
+#define ARENA_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+namespace GbArena
+{
+	//Layout order, hottest first.
+	enum Region
+	{
+		WRAM, HRAM, IO_RAM, OAM, VRAM, CART_RAM, NUM_REGIONS
+	};
+};
+
+class MemoryArena
+{
+	//Attributes
+public:
+
+private:
+	uint8_t* base = nullptr;
+	//Bytes mapped, page rounded.
+	size_t mappedSize = 0;
+	//Bytes of emulated memory, including alignment padding between regions.
+	size_t usedSize = 0;
+	size_t offsets[GbArena::NUM_REGIONS] = {0};
+	size_t sizes[GbArena::NUM_REGIONS] = {0};
+	bool hugePages = false;
+	//Methods
+public:
+	MemoryArena();
+	~MemoryArena();
+	//Owns its mapping, a copy would unmap it twice.
+	MemoryArena(const MemoryArena&) = delete;
+	MemoryArena& operator=(const MemoryArena&) = delete;
+
+	//Lays out and maps the arena, zeroed (cart ram only on a fresh mapping). Called again when a rom with a different cart ram size is loaded.
+	//Huge pages are best effort, the arena falls back to normal pages if none are available.
+	bool allocate(size_t cartRamSize, bool useHugePages);
+	void release();
+
+	uint8_t* getRegion(GbArena::Region region);
+	size_t getRegionSize(GbArena::Region region);
+
+	uint8_t* getData();
+	size_t getUsedSize();
+	size_t getMappedSize();
+	bool usesHugePages();
+
+	std::string getFootprintReport();
+private:
+};
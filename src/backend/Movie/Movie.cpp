@@ -0,0 +1,332 @@
+/*==================================================================================
+ *Class - Movie
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Input movie. Joypad changes tagged with the master cycle they happened on, keyframe states every interval frames, and an index from frame to keyframe so seeking is one state load plus at most one interval of emulation.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include "Movie.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+//Events are stored as a varint cycle delta from the previous event plus the new button byte.
+static void putVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+	while(value >= 0x80)
+	{
+		out.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((uint8_t)value);
+}
+
+static bool getVarint(const std::vector<uint8_t>& in, size_t& position, uint64_t& value)
+{
+	unsigned shift = 0;
+	value = 0;
+	while(position < in.size())
+	{
+		uint8_t byte = in[position++];
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if((byte & 0x80) == 0)
+		{
+			return true;
+		}
+		shift += 7;
+	}
+	return false;
+}
+
+struct MovieFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t keyframeInterval;
+	uint32_t reserved;
+	uint64_t length;
+	uint64_t eventCount;
+	uint64_t eventDataSize;
+	uint64_t keyframeCount;
+	uint64_t keyframeDataSize;
+};
+
+Movie::Movie(GameBoy* gb, uint32_t keyframeInterval)
+{
+	this->gb = gb;
+	this->keyframeInterval = keyframeInterval > 0 ? keyframeInterval : 1;
+}
+
+Movie::~Movie()
+{
+
+}
+
+void Movie::startRecording()
+{
+	this->events.clear();
+	this->index.clear();
+	this->keyframeData.clear();
+	this->length = 0;
+	this->currentFrame = 0;
+	this->lastButtons = this->gb->getInput();
+	this->mode = GbMovie::RECORDING;
+}
+
+void Movie::recordFrame(uint8_t buttons)
+{
+	if(this->mode != GbMovie::RECORDING)
+	{
+		return;
+	}
+	//Keyframe first, it has to hold the input latched before this frame's change.
+	if(this->currentFrame % this->keyframeInterval == 0)
+	{
+		this->captureKeyframe();
+	}
+	if(buttons != this->lastButtons)
+	{
+		this->events.push_back({this->gb->getCycleCount(), buttons});
+		this->gb->setInput(buttons);
+		this->lastButtons = buttons;
+	}
+	this->gb->runFrame();
+	this->currentFrame++;
+	this->length = this->currentFrame;
+}
+
+void Movie::stop()
+{
+	this->mode = GbMovie::IDLE;
+}
+
+bool Movie::startPlayback()
+{
+	return this->seek(0);
+}
+
+bool Movie::playFrame()
+{
+	if(this->mode != GbMovie::PLAYING || this->currentFrame >= this->length)
+	{
+		return false;
+	}
+	this->applyDueEvents();
+	this->gb->runFrame();
+	this->currentFrame++;
+	return true;
+}
+
+bool Movie::seek(uint64_t frame)
+{
+	if(this->index.empty() || frame > this->length)
+	{
+		return false;
+	}
+	if(this->mode == GbMovie::RECORDING)
+	{
+		this->stop();
+	}
+	size_t keyframe = frame / this->keyframeInterval;
+	if(keyframe >= this->index.size())
+	{
+		keyframe = this->index.size() - 1;
+	}
+	MovieIndexEntry* entry = &this->index[keyframe];
+	//Playback only runs forward from the keyframe.
+	if(entry->frame > frame)
+	{
+		return false;
+	}
+	this->scratch.setSize(entry->size);
+	std::copy(this->keyframeData.begin() + entry->offset, this->keyframeData.begin() + entry->offset + entry->size, this->scratch.getData());
+	if(!this->gb->restoreState(&this->scratch))
+	{
+		return false;
+	}
+	this->currentFrame = entry->frame;
+	this->playEvent = entry->eventIndex;
+	this->mode = GbMovie::PLAYING;
+	while(this->currentFrame < frame)
+	{
+		this->playFrame();
+	}
+	return true;
+}
+
+bool Movie::saveToFile(std::string path)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if(!file)
+	{
+		return false;
+	}
+	std::vector<uint8_t> eventData;
+	uint64_t lastCycle = 0;
+	for(MovieInputEvent& event : this->events)
+	{
+		putVarint(eventData, event.cycle - lastCycle);
+		eventData.push_back(event.buttons);
+		lastCycle = event.cycle;
+	}
+	MovieFileHeader header = {MOVIE_MAGIC, MOVIE_VERSION, this->keyframeInterval, 0, this->length, this->events.size(), eventData.size(), this->index.size(), this->keyframeData.size()};
+	file.write((const char*)&header, sizeof(header));
+	//Index before the bulk data, a reader can map a frame to its keyframe from the first few KB of the file.
+	file.write((const char*)this->index.data(), this->index.size() * sizeof(MovieIndexEntry));
+	file.write((const char*)eventData.data(), eventData.size());
+	file.write((const char*)this->keyframeData.data(), this->keyframeData.size());
+	return file.good();
+}
+
+bool Movie::loadFromFile(std::string path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if(!file)
+	{
+		return false;
+	}
+	uint64_t fileSize = (uint64_t)file.tellg();
+	file.seekg(0);
+	MovieFileHeader header;
+	file.read((char*)&header, sizeof(header));
+	if(!file.good() || header.magic != MOVIE_MAGIC || header.version != MOVIE_VERSION)
+	{
+		return false;
+	}
+	//Sizes come from the file, they have to add up to it before anything is allocated.
+	uint64_t remaining = fileSize - sizeof(header);
+	if(header.keyframeCount > remaining / sizeof(MovieIndexEntry))
+	{
+		return false;
+	}
+	remaining -= header.keyframeCount * sizeof(MovieIndexEntry);
+	if(header.eventDataSize > remaining || header.keyframeDataSize != remaining - header.eventDataSize)
+	{
+		return false;
+	}
+	//An event is at least a one byte varint and the buttons.
+	if(header.eventCount > header.eventDataSize / 2)
+	{
+		return false;
+	}
+	std::vector<MovieIndexEntry> newIndex(header.keyframeCount);
+	std::vector<uint8_t> eventData(header.eventDataSize);
+	std::vector<uint8_t> newKeyframeData(header.keyframeDataSize);
+	file.read((char*)newIndex.data(), newIndex.size() * sizeof(MovieIndexEntry));
+	file.read((char*)eventData.data(), eventData.size());
+	file.read((char*)newKeyframeData.data(), newKeyframeData.size());
+	if(!file.good())
+	{
+		return false;
+	}
+	std::vector<MovieInputEvent> newEvents;
+	newEvents.reserve(header.eventCount);
+	size_t position = 0;
+	uint64_t cycle = 0;
+	for(uint64_t i = 0; i < header.eventCount; i++)
+	{
+		uint64_t delta;
+		if(!getVarint(eventData, position, delta) || position >= eventData.size())
+		{
+			return false;
+		}
+		cycle += delta;
+		newEvents.push_back({cycle, eventData[position++]});
+	}
+	//seek copies keyframes straight out of keyframeData and starts playback at the entry's event.
+	//It finds a frame's keyframe by position, so entry i has to be frame i * interval and the entries in recording order.
+	uint32_t interval = header.keyframeInterval > 0 ? header.keyframeInterval : 1;
+	for(size_t i = 0; i < newIndex.size(); i++)
+	{
+		MovieIndexEntry& entry = newIndex[i];
+		if(entry.offset > newKeyframeData.size() || entry.size > newKeyframeData.size() - entry.offset)
+		{
+			return false;
+		}
+		if(entry.eventIndex > newEvents.size() || entry.frame > header.length || entry.frame != i * interval)
+		{
+			return false;
+		}
+		if(i > 0 && (entry.cycle <= newIndex[i - 1].cycle || entry.eventIndex < newIndex[i - 1].eventIndex))
+		{
+			return false;
+		}
+	}
+	//Only a movie that checked out replaces the current one.
+	this->stop();
+	this->keyframeInterval = interval;
+	this->length = header.length;
+	this->index.swap(newIndex);
+	this->events.swap(newEvents);
+	this->keyframeData.swap(newKeyframeData);
+	this->currentFrame = 0;
+	this->playEvent = 0;
+	return true;
+}
+
+uint64_t Movie::getLength()
+{
+	return this->length;
+}
+
+uint64_t Movie::getCurrentFrame()
+{
+	return this->currentFrame;
+}
+
+GbMovie::MovieMode Movie::getMode()
+{
+	return this->mode;
+}
+
+void Movie::captureKeyframe()
+{
+	this->gb->captureState(&this->scratch);
+	MovieIndexEntry entry = {this->currentFrame, this->gb->getCycleCount(), this->events.size(), this->keyframeData.size(), this->scratch.getSize()};
+	this->keyframeData.insert(this->keyframeData.end(), this->scratch.getData(), this->scratch.getData() + this->scratch.getSize());
+	this->index.push_back(entry);
+}
+
+void Movie::applyDueEvents()
+{
+	//Events are only recorded between frames, so they are all due by the start of the frame they belong to.
+	uint64_t now = this->gb->getCycleCount();
+	while(this->playEvent < this->events.size() && this->events[this->playEvent].cycle <= now)
+	{
+		this->gb->setInput(this->events[this->playEvent].buttons);
+		this->playEvent++;
+	}
+}
+
+/*
+<++> Movie::<++>()
+{
+
+}
+*/
@@ -0,0 +1,116 @@
+/*==================================================================================
+ *Class - Movie
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Input movie. Joypad changes tagged with the master cycle they happened on, keyframe states every interval frames, and an index from frame to keyframe so seeking is one state load plus at most one interval of emulation.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "../GameBoy.hpp"
+#include "../SaveState/SaveState.hpp"
+
+#define MOVIE_MAGIC 0x564D4247 //"GBMV"
+#define MOVIE_VERSION 1
+
+namespace GbMovie
+{
+	enum MovieMode
+	{
+		IDLE, RECORDING, PLAYING
+	};
+};
+
+struct MovieInputEvent
+{
+	uint64_t cycle;
+	uint8_t buttons;
+};
+
+struct MovieIndexEntry
+{
+	//Movie frame the keyframe was taken at, always a multiple of the interval.
+	uint64_t frame;
+	uint64_t cycle;
+	//First input event at or after the keyframe.
+	uint64_t eventIndex;
+	//Location of the keyframe's state in keyframeData.
+	uint64_t offset;
+	uint64_t size;
+};
+
+class Movie
+{
+	//Attributes
+public:
+
+private:
+	GameBoy* gb;
+	GbMovie::MovieMode mode = GbMovie::IDLE;
+	uint32_t keyframeInterval;
+	std::vector<MovieInputEvent> events;
+	std::vector<MovieIndexEntry> index;
+	std::vector<uint8_t> keyframeData;
+	SaveState scratch;
+	//Frames recorded.
+	uint64_t length = 0;
+	//Movie frame about to be run.
+	uint64_t currentFrame = 0;
+	uint8_t lastButtons = 0;
+	size_t playEvent = 0;
+	//Methods
+public:
+	Movie(GameBoy* gb, uint32_t keyframeInterval);
+	~Movie();
+
+	//Starts a new movie from the GameBoy's current state.
+	void startRecording();
+	//Latches the input for this frame and runs it.
+	void recordFrame(uint8_t buttons);
+	void stop();
+
+	bool startPlayback();
+	//Runs the next frame with the recorded input. False once the end of the movie is reached.
+	bool playFrame();
+	//Puts the GameBoy at the start of a movie frame. Leaves the movie in playback.
+	bool seek(uint64_t frame);
+
+	bool saveToFile(std::string path);
+	bool loadFromFile(std::string path);
+
+	uint64_t getLength();
+	uint64_t getCurrentFrame();
+	GbMovie::MovieMode getMode();
+private:
+	void captureKeyframe();
+	void applyDueEvents();
+};
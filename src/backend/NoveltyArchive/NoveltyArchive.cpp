@@ -0,0 +1,145 @@
+/*==================================================================================
+ *Class - NoveltyArchive
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Set of visited state hashes with visit counts. Open addressing with linear probing over one flat slot array, 16 bytes a state.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include "NoveltyArchive.hpp"
+
+NoveltyArchive::NoveltyArchive(size_t expectedStates)
+{
+	size_t capacity = 16;
+	while(capacity * ARCHIVE_MAX_LOAD_NUM < expectedStates * ARCHIVE_MAX_LOAD_DEN)
+	{
+		capacity <<= 1;
+	}
+	this->slots.assign(capacity, ArchiveSlot{0, 0, 0});
+	this->mask = capacity - 1;
+}
+
+NoveltyArchive::~NoveltyArchive()
+{
+
+}
+
+uint32_t NoveltyArchive::visit(uint64_t hash)
+{
+	if(hash == 0)
+	{
+		hash = 1;
+	}
+	size_t index = this->findSlot(hash);
+	ArchiveSlot* slot = &this->slots[index];
+	if(slot->hash == hash)
+	{
+		uint32_t previous = slot->visits;
+		if(slot->visits != UINT32_MAX)
+		{
+			slot->visits++;
+		}
+		return previous;
+	}
+	slot->hash = hash;
+	slot->visits = 1;
+	this->count++;
+	if(this->count * ARCHIVE_MAX_LOAD_DEN > this->slots.size() * ARCHIVE_MAX_LOAD_NUM)
+	{
+		this->grow();
+	}
+	return 0;
+}
+
+uint32_t NoveltyArchive::getVisits(uint64_t hash)
+{
+	if(hash == 0)
+	{
+		hash = 1;
+	}
+	ArchiveSlot* slot = &this->slots[this->findSlot(hash)];
+	return slot->hash == hash ? slot->visits : 0;
+}
+
+bool NoveltyArchive::contains(uint64_t hash)
+{
+	return this->getVisits(hash) != 0;
+}
+
+size_t NoveltyArchive::getCount()
+{
+	return this->count;
+}
+
+size_t NoveltyArchive::getMemoryUsage()
+{
+	return this->slots.capacity() * sizeof(ArchiveSlot);
+}
+
+void NoveltyArchive::clear()
+{
+	for(ArchiveSlot& slot : this->slots)
+	{
+		slot = ArchiveSlot{0, 0, 0};
+	}
+	this->count = 0;
+}
+
+//Returns the slot holding hash, or the empty slot it would go in.
+size_t NoveltyArchive::findSlot(uint64_t hash)
+{
+	//State hashes are already well mixed, the low bits make a fine index.
+	size_t index = hash & this->mask;
+	while(this->slots[index].hash != 0 && this->slots[index].hash != hash)
+	{
+		index = (index + 1) & this->mask;
+	}
+	return index;
+}
+
+void NoveltyArchive::grow()
+{
+	std::vector<ArchiveSlot> old;
+	old.swap(this->slots);
+	this->slots.assign(old.size() * 2, ArchiveSlot{0, 0, 0});
+	this->mask = this->slots.size() - 1;
+	for(ArchiveSlot& slot : old)
+	{
+		if(slot.hash != 0)
+		{
+			this->slots[this->findSlot(slot.hash)] = slot;
+		}
+	}
+}
+
+/*
+<++> NoveltyArchive::<++>()
+{
+
+}
+*/
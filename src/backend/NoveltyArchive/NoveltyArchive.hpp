@@ -0,0 +1,76 @@
+/*==================================================================================
+ *Class - NoveltyArchive
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Set of visited state hashes with visit counts. Open addressing with linear probing over one flat slot array, 16 bytes a state.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+//Grow once the table is 3/4 full.
+#define ARCHIVE_MAX_LOAD_NUM 3
+#define ARCHIVE_MAX_LOAD_DEN 4
+
+struct ArchiveSlot
+{
+	//0 marks an empty slot, a real hash of 0 is stored as 1.
+	uint64_t hash;
+	uint32_t visits;
+	uint32_t reserved;
+};
+
+class NoveltyArchive
+{
+	//Attributes
+public:
+
+private:
+	std::vector<ArchiveSlot> slots;
+	size_t mask;
+	size_t count = 0;
+	//Methods
+public:
+	//Sized so expectedStates fit without a rehash.
+	NoveltyArchive(size_t expectedStates);
+	~NoveltyArchive();
+
+	//Counts a visit. Returns the visits before this one, 0 means the state is new.
+	uint32_t visit(uint64_t hash);
+	uint32_t getVisits(uint64_t hash);
+	bool contains(uint64_t hash);
+
+	size_t getCount();
+	size_t getMemoryUsage();
+	void clear();
+private:
+	size_t findSlot(uint64_t hash);
+	void grow();
+};
@@ -0,0 +1,128 @@
+/*==================================================================================
+ *Class - FrameConverter
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Turns shade frames into a consumer's pixel format at presentation time.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <sstream>
+
+#include "FrameConverter.hpp"
+
+//DMG greys, RGBA8888 byte order on a little endian host.
+static const uint32_t dmgShades[4] = {0xFFFFFFFF, 0xFFAAAAAA, 0xFF555555, 0xFF000000};
+
+FrameConverter::FrameConverter(GbPixel::PixelFormat format)
+{
+	this->format = format;
+	this->frame.resize(FRAME_OUTPUT_PIXELS * getBytesPerPixel(format));
+	this->setPalette(dmgShades);
+}
+
+FrameConverter::~FrameConverter()
+{
+
+}
+
+void FrameConverter::setPalette(const uint32_t* colors)
+{
+	for(int i = 0; i < 4; i++)
+	{
+		uint32_t color = colors[i];
+		uint8_t r = color & 0xFF;
+		uint8_t g = (color >> 8) & 0xFF;
+		uint8_t b = (color >> 16) & 0xFF;
+		this->colors[i] = color;
+		this->colors16[i] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+		//BT.601 luma.
+		this->colors8[i] = (r * 77 + g * 150 + b * 29) >> 8;
+	}
+	//The held frame was converted with the old colours.
+	this->haveFrame = false;
+}
+
+GbPixel::PixelFormat FrameConverter::getFormat()
+{
+	return this->format;
+}
+
+const uint8_t* FrameConverter::present(FrameOutput* output)
+{
+	FrameInfo info;
+	const uint8_t* shades = output->acquire(&info);
+	if(this->haveFrame && info.generation == this->frameGeneration)
+	{
+		this->skippedFrames++;
+		return this->frame.data();
+	}
+	this->convertLine(shades, this->frame.data(), FRAME_OUTPUT_PIXELS);
+	this->frameGeneration = info.generation;
+	this->haveFrame = true;
+	this->convertedFrames++;
+	return this->frame.data();
+}
+
+void FrameConverter::convertLine(const uint8_t* shades, uint8_t* out, size_t count)
+{
+	switch(this->format)
+	{
+		case GbPixel::RGBA8888:
+			PixelKernels::expandShades(shades, this->colors, (uint32_t*)out, count);
+			break;
+		case GbPixel::RGB565:
+			PixelKernels::expandShades16(shades, this->colors16, (uint16_t*)out, count);
+			break;
+		case GbPixel::RGB888:
+			PixelKernels::expandShades24(shades, this->colors, out, count);
+			break;
+		case GbPixel::GRAY8:
+			PixelKernels::expandShades8(shades, this->colors8, out, count);
+			break;
+	}
+}
+
+std::string FrameConverter::getReport()
+{
+	std::ostringstream report;
+	report << "Presented: " << this->convertedFrames << " converted, " << this->skippedFrames << " unchanged and skipped (" << PixelKernels::getLevelName() << ")\n";
+	return report.str();
+}
+
+size_t FrameConverter::getBytesPerPixel(GbPixel::PixelFormat format)
+{
+	static const size_t sizes[4] = {4, 2, 3, 1};
+	return sizes[format];
+}
+
+/*
+<++> FrameConverter::<++>()
+{
+
+}
+*/
@@ -0,0 +1,92 @@
+/*==================================================================================
+ *Class - FrameConverter
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Turns shade frames into a consumer's pixel format at presentation time.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "../FrameOutput/FrameOutput.hpp"
+#include "../PixelKernels/PixelKernels.hpp"
+
+namespace GbPixel
+{
+enum PixelFormat
+{
+	//Qt, byte order R G B A.
+	RGBA8888,
+	//LED panels.
+	RGB565,
+	RGB888,
+	//RL observations.
+	GRAY8
+};
+}
+
+//One per consumer, it keeps the converted frame and the generation it came from.
+class FrameConverter
+{
+	//Attributes
+public:
+
+private:
+	GbPixel::PixelFormat format;
+	//Shades 0-3 in RGBA8888 and the tables built from them for each format.
+	uint32_t colors[4];
+	uint16_t colors16[4];
+	uint8_t colors8[4];
+	std::vector<uint8_t> frame;
+	uint64_t frameGeneration = 0;
+	bool haveFrame = false;
+	uint64_t convertedFrames = 0;
+	uint64_t skippedFrames = 0;
+	//Methods
+public:
+	FrameConverter(GbPixel::PixelFormat format);
+	~FrameConverter();
+
+	//RGBA8888 colours for shades 0 (lightest) to 3. DMG greys until set.
+	void setPalette(const uint32_t* colors);
+	GbPixel::PixelFormat getFormat();
+
+	//Consumer side of output. The newest frame in this format, converted only when its generation is new.
+	//Good until the next present.
+	const uint8_t* present(FrameOutput* output);
+	//count shades to pixels in this format, for lines from a LineOutput.
+	void convertLine(const uint8_t* shades, uint8_t* out, size_t count);
+
+	std::string getReport();
+
+	static size_t getBytesPerPixel(GbPixel::PixelFormat format);
+private:
+};
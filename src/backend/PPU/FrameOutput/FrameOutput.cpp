@@ -0,0 +1,155 @@
+/*==================================================================================
+ *Class - FrameOutput
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Lock free triple buffer handing finished frames from the emulation thread to one consumer.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <ctime>
+#include <cstring>
+#include <sstream>
+
+#include "FrameOutput.hpp"
+
+FrameOutput::FrameOutput()
+{
+	//Shade 0, a blank screen.
+	memset(this->buffers, 0, sizeof(this->buffers));
+	for(int b = 0; b < FRAME_OUTPUT_BUFFERS; b++)
+	{
+		this->infos[b].frameNumber = 0;
+		this->infos[b].publishNs = 0;
+		this->infos[b].generation = 0;
+	}
+	this->middle.store(1, std::memory_order_relaxed);
+	this->publishedFrames.store(0, std::memory_order_relaxed);
+	this->droppedFrames.store(0, std::memory_order_relaxed);
+	this->acquiredFrames.store(0, std::memory_order_relaxed);
+	this->latencyTotalNs.store(0, std::memory_order_relaxed);
+	this->latencyMaxNs.store(0, std::memory_order_relaxed);
+}
+
+FrameOutput::~FrameOutput()
+{
+
+}
+
+uint8_t* FrameOutput::getBackBuffer()
+{
+	return this->buffers[this->back];
+}
+
+void FrameOutput::publish(uint64_t frameNumber)
+{
+	//23 KB compare, far cheaper than the conversions it lets consumers skip on a still screen.
+	if(memcmp(this->buffers[this->back], this->buffers[this->lastPublished], FRAME_OUTPUT_PIXELS) != 0)
+	{
+		this->generation++;
+	}
+	this->infos[this->back].frameNumber = frameNumber;
+	this->infos[this->back].generation = this->generation;
+	this->infos[this->back].publishNs = nowNs();
+	//Release makes the pixels and info visible to the consumer's acquire of the slot.
+	uint8_t old = this->middle.exchange(this->back | FRAME_OUTPUT_FRESH, std::memory_order_acq_rel);
+	this->lastPublished = this->back;
+	this->back = old & 0x03;
+	this->publishedFrames.fetch_add(1, std::memory_order_relaxed);
+	if((old & FRAME_OUTPUT_FRESH) != 0)
+	{
+		this->droppedFrames.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+const uint8_t* FrameOutput::getLastPublished()
+{
+	//Either in the slot or the consumer's front, neither side writes it until it comes back through publish.
+	return this->buffers[this->lastPublished];
+}
+
+bool FrameOutput::hasNewFrame()
+{
+	return (this->middle.load(std::memory_order_relaxed) & FRAME_OUTPUT_FRESH) != 0;
+}
+
+const uint8_t* FrameOutput::acquire(FrameInfo* info)
+{
+	if(this->hasNewFrame())
+	{
+		uint8_t old = this->middle.exchange(this->front, std::memory_order_acq_rel);
+		this->front = old & 0x03;
+		uint64_t latency = nowNs() - this->infos[this->front].publishNs;
+		this->acquiredFrames.fetch_add(1, std::memory_order_relaxed);
+		this->latencyTotalNs.fetch_add(latency, std::memory_order_relaxed);
+		if(latency > this->latencyMaxNs.load(std::memory_order_relaxed))
+		{
+			this->latencyMaxNs.store(latency, std::memory_order_relaxed);
+		}
+	}
+	if(info != nullptr)
+	{
+		*info = this->infos[this->front];
+	}
+	return this->buffers[this->front];
+}
+
+uint64_t FrameOutput::getPublishedCount()
+{
+	return this->publishedFrames.load(std::memory_order_relaxed);
+}
+
+uint64_t FrameOutput::getDroppedCount()
+{
+	return this->droppedFrames.load(std::memory_order_relaxed);
+}
+
+std::string FrameOutput::getReport()
+{
+	std::ostringstream report;
+	uint64_t acquired = this->acquiredFrames.load(std::memory_order_relaxed);
+	report << "Frames: " << this->getPublishedCount() << " published, " << acquired << " acquired, " << this->getDroppedCount() << " dropped\n";
+	if(acquired > 0)
+	{
+		report << "Publish to acquire: " << this->latencyTotalNs.load(std::memory_order_relaxed) / acquired / 1000 << " us average, " << this->latencyMaxNs.load(std::memory_order_relaxed) / 1000 << " us max\n";
+	}
+	return report.str();
+}
+
+uint64_t FrameOutput::nowNs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/*
+<++> FrameOutput::<++>()
+{
+
+}
+*/
@@ -0,0 +1,106 @@
+/*==================================================================================
+ *Class - FrameOutput
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Lock free triple buffer handing finished frames from the emulation thread to one consumer.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#define FRAME_OUTPUT_WIDTH 160
+#define FRAME_OUTPUT_HEIGHT 144
+#define FRAME_OUTPUT_PIXELS (FRAME_OUTPUT_WIDTH * FRAME_OUTPUT_HEIGHT)
+#define FRAME_OUTPUT_BUFFERS 3
+//The shared slot holds a buffer index in bits 0-1, this bit is set while the frame in it has not been picked up.
+#define FRAME_OUTPUT_FRESH 0x04
+
+struct FrameInfo
+{
+	//PPU frame count when the frame was published.
+	uint64_t frameNumber;
+	//CLOCK_MONOTONIC.
+	uint64_t publishNs;
+	//Bumped only when the frame differs from the one published before it, equal generations are equal pixels.
+	uint64_t generation;
+};
+
+//Frames are shades 0-3, a byte a pixel. FrameConverter turns them into the consumer's format.
+//One producer, the thread running the GameBoy, and one consumer (UI, encoder, RL client).
+//The producer draws into the back buffer and swaps it with the shared slot, the consumer swaps the shared slot with its front buffer.
+//Neither side waits on the other, and a frame the consumer holds is never written until it lets go of it with the next acquire.
+class FrameOutput
+{
+	//Attributes
+public:
+
+private:
+	alignas(64) uint8_t buffers[FRAME_OUTPUT_BUFFERS][FRAME_OUTPUT_PIXELS];
+	FrameInfo infos[FRAME_OUTPUT_BUFFERS];
+	//Producer side.
+	uint8_t back = 0;
+	uint8_t lastPublished = 1;
+	uint64_t generation = 0;
+	//Handed between the two sides.
+	alignas(64) std::atomic<uint8_t> middle;
+	//Consumer side.
+	alignas(64) uint8_t front = 2;
+	std::atomic<uint64_t> publishedFrames;
+	//Published frames replaced before the consumer picked them up.
+	std::atomic<uint64_t> droppedFrames;
+	std::atomic<uint64_t> acquiredFrames;
+	//Publish to acquire, over the acquired frames.
+	std::atomic<uint64_t> latencyTotalNs;
+	std::atomic<uint64_t> latencyMaxNs;
+	//Methods
+public:
+	FrameOutput();
+	~FrameOutput();
+
+	//Producer. The frame being drawn.
+	uint8_t* getBackBuffer();
+	//Hands the back buffer to the consumer and takes a free one. Never blocks.
+	void publish(uint64_t frameNumber);
+	//Producer. The frame last published, good until the next publish.
+	const uint8_t* getLastPublished();
+
+	//Consumer. True when a frame newer than the one held is waiting.
+	bool hasNewFrame();
+	//Consumer. The newest published frame, unchanged until the next acquire, no copy. Same frame again when nothing new came in.
+	const uint8_t* acquire(FrameInfo* info);
+
+	uint64_t getPublishedCount();
+	uint64_t getDroppedCount();
+	//Counters and publish to acquire latency. Any thread.
+	std::string getReport();
+
+	static uint64_t nowNs();
+private:
+};
@@ -0,0 +1,142 @@
+/*==================================================================================
+ *Class - LineOutput
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Single producer single consumer queue of finished scanlines for displays that scan out while the frame is still being emulated.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <cstring>
+#include <sstream>
+
+#include "LineOutput.hpp"
+
+LineOutput::LineOutput(uint8_t linesPerPush)
+{
+	this->setLinesPerPush(linesPerPush);
+	this->pushedIndex.store(0, std::memory_order_relaxed);
+	this->poppedIndex.store(0, std::memory_order_relaxed);
+	this->pushedLines.store(0, std::memory_order_relaxed);
+	this->droppedLines.store(0, std::memory_order_relaxed);
+	this->poppedLines.store(0, std::memory_order_relaxed);
+	this->latencyTotalNs.store(0, std::memory_order_relaxed);
+	this->latencyMaxNs.store(0, std::memory_order_relaxed);
+}
+
+LineOutput::~LineOutput()
+{
+
+}
+
+void LineOutput::setLinesPerPush(uint8_t lines)
+{
+	this->linesPerPush = (lines == 0) ? 1 : lines;
+}
+
+void LineOutput::pushLine(uint64_t frameNumber, uint8_t line, const uint8_t* pixels)
+{
+	if(this->writeIndex - this->poppedIndex.load(std::memory_order_acquire) >= LINE_OUTPUT_SLOTS)
+	{
+		this->droppedLines.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	ScanLine* slot = &this->slots[this->writeIndex & (LINE_OUTPUT_SLOTS - 1)];
+	slot->frameNumber = frameNumber;
+	slot->renderNs = FrameOutput::nowNs();
+	slot->line = line;
+	memcpy(slot->pixels, pixels, sizeof(slot->pixels));
+	this->writeIndex++;
+	if(this->writeIndex - this->pushedIndex.load(std::memory_order_relaxed) >= this->linesPerPush)
+	{
+		this->flush();
+	}
+}
+
+void LineOutput::flush()
+{
+	uint32_t pushed = this->pushedIndex.load(std::memory_order_relaxed);
+	if(pushed == this->writeIndex)
+	{
+		return;
+	}
+	this->pushedLines.fetch_add(this->writeIndex - pushed, std::memory_order_relaxed);
+	//Release publishes the slot contents along with the index.
+	this->pushedIndex.store(this->writeIndex, std::memory_order_release);
+}
+
+const ScanLine* LineOutput::peek()
+{
+	uint32_t popped = this->poppedIndex.load(std::memory_order_relaxed);
+	if(popped == this->pushedIndex.load(std::memory_order_acquire))
+	{
+		return nullptr;
+	}
+	return &this->slots[popped & (LINE_OUTPUT_SLOTS - 1)];
+}
+
+void LineOutput::pop()
+{
+	uint32_t popped = this->poppedIndex.load(std::memory_order_relaxed);
+	if(popped == this->pushedIndex.load(std::memory_order_acquire))
+	{
+		return;
+	}
+	uint64_t latency = FrameOutput::nowNs() - this->slots[popped & (LINE_OUTPUT_SLOTS - 1)].renderNs;
+	this->poppedLines.fetch_add(1, std::memory_order_relaxed);
+	this->latencyTotalNs.fetch_add(latency, std::memory_order_relaxed);
+	if(latency > this->latencyMaxNs.load(std::memory_order_relaxed))
+	{
+		this->latencyMaxNs.store(latency, std::memory_order_relaxed);
+	}
+	//Release hands the slot back only after it has been read.
+	this->poppedIndex.store(popped + 1, std::memory_order_release);
+}
+
+uint32_t LineOutput::getQueuedLines()
+{
+	return this->pushedIndex.load(std::memory_order_acquire) - this->poppedIndex.load(std::memory_order_relaxed);
+}
+
+std::string LineOutput::getReport()
+{
+	std::ostringstream report;
+	uint64_t popped = this->poppedLines.load(std::memory_order_relaxed);
+	report << "Lines: " << this->pushedLines.load(std::memory_order_relaxed) << " pushed, " << popped << " popped, " << this->droppedLines.load(std::memory_order_relaxed) << " dropped, " << (int)this->linesPerPush << " per push\n";
+	if(popped > 0)
+	{
+		report << "Render to pop: " << this->latencyTotalNs.load(std::memory_order_relaxed) / popped / 1000 << " us average, " << this->latencyMaxNs.load(std::memory_order_relaxed) / 1000 << " us max\n";
+	}
+	return report.str();
+}
+
+/*
+<++> LineOutput::<++>()
+{
+
+}
+*/
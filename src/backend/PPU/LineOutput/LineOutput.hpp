@@ -0,0 +1,94 @@
+/*==================================================================================
+ *Class - LineOutput
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Single producer single consumer queue of finished scanlines for displays that scan out while the frame is still being emulated.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "../FrameOutput/FrameOutput.hpp"
+
+//Power of two. A little under two frames of lines.
+#define LINE_OUTPUT_SLOTS 256
+
+struct ScanLine
+{
+	//Frame the line belongs to, the number FrameOutput publishes it under.
+	uint64_t frameNumber;
+	//CLOCK_MONOTONIC when the PPU finished the line.
+	uint64_t renderNs;
+	uint8_t line;
+	//Shades 0-3, FrameConverter::convertLine puts them in the panel's format.
+	uint8_t pixels[FRAME_OUTPUT_WIDTH];
+};
+
+//The PPU pushes lines as it draws them, made visible linesPerPush at a time and at the end of every frame.
+//One consumer thread pops them. The PPU never waits, lines that find the queue full are dropped and counted.
+class LineOutput
+{
+	//Attributes
+public:
+
+private:
+	alignas(64) ScanLine slots[LINE_OUTPUT_SLOTS];
+	uint8_t linesPerPush;
+	//Producer side. Lines written past pushedIndex are not visible yet.
+	uint32_t writeIndex = 0;
+	alignas(64) std::atomic<uint32_t> pushedIndex;
+	//Consumer side.
+	alignas(64) std::atomic<uint32_t> poppedIndex;
+	std::atomic<uint64_t> pushedLines;
+	std::atomic<uint64_t> droppedLines;
+	std::atomic<uint64_t> poppedLines;
+	//Line rendered to line popped.
+	std::atomic<uint64_t> latencyTotalNs;
+	std::atomic<uint64_t> latencyMaxNs;
+	//Methods
+public:
+	LineOutput(uint8_t linesPerPush);
+	~LineOutput();
+
+	//Producer. 1 hands over every line as it is drawn, larger batches cost fewer cache line transfers.
+	void setLinesPerPush(uint8_t lines);
+	void pushLine(uint64_t frameNumber, uint8_t line, const uint8_t* pixels);
+	//Producer. Makes every written line visible, the PPU calls it at VBlank.
+	void flush();
+
+	//Consumer. Oldest line not yet popped, nullptr when the queue is empty. Good until pop.
+	const ScanLine* peek();
+	void pop();
+	uint32_t getQueuedLines();
+
+	//Counters and render to pop latency. Any thread.
+	std::string getReport();
+private:
+};
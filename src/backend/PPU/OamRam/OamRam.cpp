@@ -1,9 +1,9 @@
 /*==================================================================================
  *Class - OamRam
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Object Attribute Memory 0xFE00 -> 0xFE9F
 ====================================================================================*/
 
 /*
@@ -31,24 +31,163 @@
 
 #pragma once
 
-#include "OamRam.hpp"
-
-
-
-
+#include <cstring>
 
+#include "OamRam.hpp"
 
+OamRam::OamRam()
+{
+	memset(this->lineMasks, 0, sizeof(this->lineMasks));
+	memset(this->lineCounts, 0, sizeof(this->lineCounts));
+	memset(this->staleLines, 0, sizeof(this->staleLines));
+}
 
+OamRam::~OamRam()
+{
 
+}
 
+uint8_t OamRam::read(uint16_t address)
+{
+	uint8_t localAddr = address & 0x00FF;
+	if(localAddr >= OAM_RAM_SIZE)
+	{
+		return 0xFF;
+	}
+	return this->oam[localAddr];
+}
 
+void OamRam::write(uint16_t address, uint8_t value)
+{
+	uint8_t localAddr = address & 0x00FF;
+	if(localAddr >= OAM_RAM_SIZE)
+	{
+		return;
+	}
+	uint8_t oldValue = this->oam[localAddr];
+	this->oam[localAddr] = value;
+	if(oldValue == value)
+	{
+		return;
+	}
+	uint8_t sprite = localAddr >> 2;
+	switch(localAddr & 0x03)
+	{
+		case 0:
+			//Moved vertically, off its old lines and onto the new ones.
+			this->updateLines(sprite, oldValue, false);
+			this->updateLines(sprite, value, true);
+			break;
+		case 1:
+			//Same lines, the x order on them may have changed.
+			this->markLinesStale(this->oam[sprite * 4]);
+			break;
+		default:
+			//Tile and flags are read by the PPU straight from OAM, the lists do not care.
+			break;
+	}
+}
 
+void OamRam::attach(uint8_t* memory)
+{
+	this->oam = memory;
+	this->rebuildLines();
+}
 
+uint8_t* OamRam::getData()
+{
+	return this->oam;
+}
 
+const uint8_t* OamRam::getLineSprites(uint8_t ly, uint8_t height, uint8_t* count)
+{
+	if(height != this->spriteHeight)
+	{
+		this->spriteHeight = height;
+		this->rebuildLines();
+	}
+	if(ly >= OAM_LINE_COUNT)
+	{
+		*count = 0;
+		return this->lineSprites[0];
+	}
+	if((this->staleLines[ly >> 6] & (1ULL << (ly & 63))) != 0)
+	{
+		this->buildLine(ly);
+	}
+	*count = this->lineCounts[ly];
+	return this->lineSprites[ly];
+}
 
+void OamRam::rebuildLines()
+{
+	memset(this->lineMasks, 0, sizeof(this->lineMasks));
+	memset(this->staleLines, 0xFF, sizeof(this->staleLines));
+	if(this->oam == nullptr)
+	{
+		return;
+	}
+	for(uint8_t i = 0; i < OAM_SPRITE_COUNT; i++)
+	{
+		int top = this->oam[i * 4] - 16;
+		int bottom = top + this->spriteHeight;
+		for(int line = (top < 0) ? 0 : top; line < bottom && line < OAM_LINE_COUNT; line++)
+		{
+			this->lineMasks[line] |= 1ULL << i;
+		}
+	}
+}
 
+void OamRam::updateLines(uint8_t sprite, uint8_t y, bool set)
+{
+	int top = y - 16;
+	int bottom = top + this->spriteHeight;
+	uint64_t bit = 1ULL << sprite;
+	for(int line = (top < 0) ? 0 : top; line < bottom && line < OAM_LINE_COUNT; line++)
+	{
+		if(set)
+		{
+			this->lineMasks[line] |= bit;
+		}
+		else
+		{
+			this->lineMasks[line] &= ~bit;
+		}
+		this->staleLines[line >> 6] |= 1ULL << (line & 63);
+	}
+}
 
+void OamRam::markLinesStale(uint8_t y)
+{
+	int top = y - 16;
+	int bottom = top + this->spriteHeight;
+	for(int line = (top < 0) ? 0 : top; line < bottom && line < OAM_LINE_COUNT; line++)
+	{
+		this->staleLines[line >> 6] |= 1ULL << (line & 63);
+	}
+}
 
+void OamRam::buildLine(uint8_t ly)
+{
+	//The first 10 in OAM order that cover the line, then DMG priority: lower x first, OAM order on a tie.
+	uint64_t mask = this->lineMasks[ly];
+	uint8_t* found = this->lineSprites[ly];
+	int count = 0;
+	while(mask != 0 && count < OAM_MAX_LINE_SPRITES)
+	{
+		uint8_t i = __builtin_ctzll(mask);
+		mask &= mask - 1;
+		int at = count++;
+		while(at > 0 && this->oam[found[at - 1] * 4 + 1] > this->oam[i * 4 + 1])
+		{
+			found[at] = found[at - 1];
+			at--;
+		}
+		found[at] = i;
+	}
+	this->lineCounts[ly] = count;
+	this->staleLines[ly >> 6] &= ~(1ULL << (ly & 63));
+}
 
 
 /*
@@ -1,9 +1,9 @@
 /*==================================================================================
  *Class - OamRam
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Object Attribute Memory 0xFE00 -> 0xFE9F
 ====================================================================================*/
 
 /*
@@ -29,7 +29,15 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#pragma once
 
+#include <cstdint>
+
+#define OAM_RAM_SIZE 160
+#define OAM_SPRITE_COUNT 40
+//Lines the PPU draws, the buckets only cover these.
+#define OAM_LINE_COUNT 144
+#define OAM_MAX_LINE_SPRITES 10
 
 class OamRam
 {
@@ -37,10 +45,35 @@ class OamRam
 public:
 
 private:
+	uint8_t* oam = nullptr;
+	//Sprites covering each line, bit n = OAM entry n. Kept current on every write.
+	uint64_t lineMasks[OAM_LINE_COUNT];
+	//Per line list of up to OAM_MAX_LINE_SPRITES in DMG priority, built from the mask when the PPU first asks for the line.
+	uint8_t lineSprites[OAM_LINE_COUNT][OAM_MAX_LINE_SPRITES];
+	uint8_t lineCounts[OAM_LINE_COUNT];
+	//Bit per line, set when the line's list no longer matches OAM.
+	uint64_t staleLines[(OAM_LINE_COUNT + 63) / 64];
+	uint8_t spriteHeight = 8;
 	//Methods
 public:
 	OamRam();
 	~OamRam();
 
+	uint8_t read(uint16_t address);
+	void write(uint16_t address, uint8_t value);
+
+	//Points the memory at its region of the arena, OAM_RAM_SIZE bytes.
+	void attach(uint8_t* memory);
+	uint8_t* getData();
+
+	//Sprites on line ly, highest priority first, at most OAM_MAX_LINE_SPRITES. Height is 8 or 16 from LCDC bit 2.
+	//The pointer is good until the next OAM write.
+	const uint8_t* getLineSprites(uint8_t ly, uint8_t height, uint8_t* count);
+	//Rebuilds every bucket in one pass. Call after OAM changes behind write's back, the DMA block copy or a state load.
+	void rebuildLines();
 private:
+	//Sets or clears the sprite's bit on every line it covers at top byte y, and marks those lines stale.
+	void updateLines(uint8_t sprite, uint8_t y, bool set);
+	void markLinesStale(uint8_t y);
+	void buildLine(uint8_t ly);
 };
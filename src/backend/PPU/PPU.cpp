@@ -1,9 +1,9 @@
 /*==================================================================================
- *Class -
+ *Class - PPU
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 7/22/22
+ *Last Changed - 10/19/26
+ *Description - Gameboy Pixel Processing Unit.
 ====================================================================================*/
 
 /*
@@ -29,30 +29,503 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+
 #pragma once
 
-#include "CHANGE.hpp"
+#include <cstring>
+#include <sstream>
+
+#include "PPU.hpp"
+
+PPU::PPU(IoRam* ioRam, VRAM* vram, OamRam* oamRam)
+{
+	this->ioRam = ioRam;
+	this->vram = vram;
+	this->oamRam = oamRam;
+	this->ioRam->registerHandler(io_reg::LCDC, nullptr, &PPU::writeLcdc, this);
+	this->ioRam->registerHandler(io_reg::STAT, nullptr, &PPU::writeStat, this);
+	this->ioRam->registerHandler(io_reg::LYC, nullptr, &PPU::writeLyc, this);
+	static const uint8_t lineRegs[7] = {io_reg::SCY, io_reg::SCX, io_reg::BGP, io_reg::OBP0, io_reg::OBP1, io_reg::WY, io_reg::WX};
+	for(int i = 0; i < 7; i++)
+	{
+		this->ioRam->registerHandler(lineRegs[i], nullptr, &PPU::writeLineReg, this);
+	}
+	memset(this->bgLine, 0, sizeof(this->bgLine));
+	this->reset();
+}
+
+PPU::~PPU()
+{
+
+}
+
+void PPU::reset()
+{
+	this->lineDot = 0;
+	this->nextEventDot = 0;
+	this->windowLine = 0;
+	this->statLine = false;
+	this->frameCount = 0;
+	this->lineWriteCount = 0;
+	std::memset(this->lineWrites, 0, sizeof(this->lineWrites));
+	this->fastLines = 0;
+	this->dotLines = 0;
+	//The screen goes blank on a reset.
+	memset(this->output.getBackBuffer(), 0, PPU_SCREEN_WIDTH * PPU_SCREEN_HEIGHT);
+	this->output.publish(this->frameCount);
+	this->renderFrame = this->renderEnabled;
+}
+
+void PPU::tick(uint32_t cycles)
+{
+	uint8_t* regs = this->ioRam->getData();
+	if((regs[io_reg::LCDC] & 0x80) == 0)
+	{
+		return;
+	}
+	this->lineDot += cycles;
+	if(this->lineDot < this->nextEventDot)
+	{
+		return;
+	}
+	//One instruction can cross more than one mode boundary, step through all of them.
+	while(true)
+	{
+		uint8_t mode = regs[io_reg::STAT] & 0x03;
+		if(mode == GbPpu::OAM_SCAN && this->lineDot >= PPU_OAM_SCAN_DOTS)
+		{
+			this->lineWriteCount = 0;
+			this->setMode(regs, GbPpu::DRAWING);
+		}
+		else if(mode == GbPpu::DRAWING && this->lineDot >= PPU_OAM_SCAN_DOTS + PPU_DRAW_DOTS)
+		{
+			if(this->renderFrame)
+			{
+				this->renderLine(regs);
+			}
+			this->setMode(regs, GbPpu::HBLANK);
+		}
+		else if(this->lineDot >= PPU_DOTS_PER_LINE)
+		{
+			this->lineDot -= PPU_DOTS_PER_LINE;
+			this->endLine(regs);
+		}
+		else
+		{
+			this->nextEventDot = (mode == GbPpu::OAM_SCAN) ? PPU_OAM_SCAN_DOTS : ((mode == GbPpu::DRAWING) ? PPU_OAM_SCAN_DOTS + PPU_DRAW_DOTS : PPU_DOTS_PER_LINE);
+			break;
+		}
+	}
+}
+
+void PPU::setRenderEnabled(bool enabled)
+{
+	this->renderEnabled = enabled;
+}
+
+bool PPU::isRenderEnabled()
+{
+	return this->renderEnabled;
+}
+
+void PPU::setForceDotRenderer(bool force)
+{
+	this->forceDotRenderer = force;
+}
+
+std::string PPU::getRenderReport()
+{
+	std::ostringstream report;
+	uint64_t total = this->fastLines + this->dotLines;
+	report << "Lines: " << this->fastLines << " scanline, " << this->dotLines << " dot accurate";
+	if(total > 0)
+	{
+		report << " (" << (100.0 * this->dotLines) / total << "% dot accurate)";
+	}
+	report << "\n";
+	return report.str();
+}
+
+const uint8_t* PPU::getFramebuffer()
+{
+	return this->output.getLastPublished();
+}
+
+FrameOutput* PPU::getFrameOutput()
+{
+	return &this->output;
+}
+
+void PPU::setLineOutput(LineOutput* lineOutput)
+{
+	this->lineOutput = lineOutput;
+}
 
+uint64_t PPU::getFrameCount()
+{
+	return this->frameCount;
+}
 
+void PPU::saveState(SaveState* state)
+{
+	state->write(this->lineDot);
+	state->write(this->windowLine);
+	state->write(this->statLine);
+	state->write(this->frameCount);
+	state->write(this->lineWriteCount);
+	//The whole log, every state of a rom is then the same size and Rewind can XOR one against the next.
+	state->writeBlock(this->lineWrites, sizeof(this->lineWrites));
+}
 
+bool PPU::loadState(SaveState* state)
+{
+	bool ok = state->read(this->lineDot);
+	ok = ok && state->read(this->windowLine);
+	ok = ok && state->read(this->statLine);
+	ok = ok && state->read(this->frameCount);
+	ok = ok && state->read(this->lineWriteCount) && this->lineWriteCount <= PPU_MAX_LINE_WRITES;
+	ok = ok && state->readBlock(this->lineWrites, sizeof(this->lineWrites));
+	this->nextEventDot = 0;
+	//The lines drawn so far belong to another timeline, this frame is not shown.
+	this->renderFrame = false;
+	return ok;
+}
 
+void PPU::setMode(uint8_t* regs, GbPpu::PpuMode mode)
+{
+	regs[io_reg::STAT] = (regs[io_reg::STAT] & 0xFC) | mode;
+	this->updateStat(regs);
+}
 
+void PPU::updateStat(uint8_t* regs)
+{
+	uint8_t stat = regs[io_reg::STAT];
+	if(regs[io_reg::LY] == regs[io_reg::LYC])
+	{
+		stat |= 0x04;
+	}
+	else
+	{
+		stat &= ~0x04;
+	}
+	regs[io_reg::STAT] = stat;
+	//Every enabled source is ORed onto one line, only a rising edge requests the interrupt.
+	uint8_t mode = stat & 0x03;
+	bool line = ((stat & 0x44) == 0x44);
+	line = line || (mode == GbPpu::HBLANK && (stat & 0x08) != 0);
+	line = line || (mode == GbPpu::VBLANK && (stat & 0x10) != 0);
+	line = line || (mode == GbPpu::OAM_SCAN && (stat & 0x20) != 0);
+	if(line && !this->statLine)
+	{
+		regs[io_reg::IF] |= 0x02;
+	}
+	this->statLine = line;
+}
 
+void PPU::endLine(uint8_t* regs)
+{
+	uint8_t ly = regs[io_reg::LY] + 1;
+	if(ly == PPU_SCREEN_HEIGHT)
+	{
+		regs[io_reg::LY] = ly;
+		regs[io_reg::IF] |= 0x01;
+		this->frameCount++;
+		if(this->renderFrame)
+		{
+			this->output.publish(this->frameCount);
+		}
+		if(this->lineOutput != nullptr)
+		{
+			this->lineOutput->flush();
+		}
+		this->setMode(regs, GbPpu::VBLANK);
+	}
+	else if(ly >= PPU_LINES_PER_FRAME)
+	{
+		regs[io_reg::LY] = 0;
+		this->windowLine = 0;
+		this->renderFrame = this->renderEnabled;
+		this->setMode(regs, GbPpu::OAM_SCAN);
+	}
+	else
+	{
+		regs[io_reg::LY] = ly;
+		this->setMode(regs, (ly < PPU_SCREEN_HEIGHT) ? GbPpu::OAM_SCAN : GbPpu::VBLANK);
+	}
+}
 
+void PPU::renderLine(uint8_t* regs)
+{
+	uint8_t ly = regs[io_reg::LY];
+	if(ly >= PPU_SCREEN_HEIGHT)
+	{
+		return;
+	}
+	this->tileCache.update(this->vram);
+	if(this->lineWriteCount == 0 && !this->forceDotRenderer)
+	{
+		this->renderLineFast(regs, ly);
+		this->fastLines++;
+	}
+	else
+	{
+		this->renderLineDots(regs, ly);
+		this->dotLines++;
+	}
+	//Shades as they are, the consumer picks the colours when it presents the frame.
+	uint8_t* pixels = this->output.getBackBuffer() + ly * PPU_SCREEN_WIDTH;
+	memcpy(pixels, this->shadeLine, PPU_SCREEN_WIDTH);
+	if(this->lineOutput != nullptr)
+	{
+		//Numbered as FrameOutput will publish it, frameCount counts the VBlank that ends this frame.
+		this->lineOutput->pushLine(this->frameCount + 1, ly, pixels);
+	}
+}
 
+void PPU::renderLineFast(uint8_t* regs, uint8_t ly)
+{
+	uint8_t lcdc = regs[io_reg::LCDC];
+	//On the DMG LCDC bit 0 blanks the background and the window together.
+	if((lcdc & 0x01) != 0)
+	{
+		this->renderBackground(regs, ly);
+		if((lcdc & 0x20) != 0)
+		{
+			this->renderWindow(regs, ly);
+		}
+	}
+	else
+	{
+		memset(this->bgLine, 0, sizeof(this->bgLine));
+	}
+	PixelKernels::mapPalette(this->bgLine + 8, regs[io_reg::BGP], this->shadeLine, PPU_SCREEN_WIDTH);
+	if((lcdc & 0x02) == 0)
+	{
+		return;
+	}
+	this->scanSprites(regs, ly);
+	uint8_t obp0 = regs[io_reg::OBP0];
+	uint8_t obp1 = regs[io_reg::OBP1];
+	uint8_t shades[2][4] = {{0, (uint8_t)((obp0 >> 2) & 0x03), (uint8_t)((obp0 >> 4) & 0x03), (uint8_t)((obp0 >> 6) & 0x03)},
+		{0, (uint8_t)((obp1 >> 2) & 0x03), (uint8_t)((obp1 >> 4) & 0x03), (uint8_t)((obp1 >> 6) & 0x03)}};
+	for(int x = 0; x < PPU_SCREEN_WIDTH; x++)
+	{
+		uint8_t sprite = this->spriteLine[x];
+		if(sprite != 0 && ((sprite & 0x80) == 0 || this->bgLine[x + 8] == 0))
+		{
+			this->shadeLine[x] = shades[(sprite >> 4) & 0x01][sprite & 0x03];
+		}
+	}
+}
 
+void PPU::renderLineDots(uint8_t* regs, uint8_t ly)
+{
+	//Wind the registers back to how the line started, then replay the writes as the pixels pass them.
+	uint8_t lineRegs[IO_RAM_SIZE];
+	memcpy(lineRegs, regs, IO_RAM_SIZE);
+	for(int i = this->lineWriteCount - 1; i >= 0; i--)
+	{
+		lineRegs[this->lineWrites[i].reg] = this->lineWrites[i].oldValue;
+	}
+	//OAM scan, sprite height and WY are all settled before drawing starts.
+	this->scanSprites(lineRegs, ly);
+	bool windowOnLine = ly >= lineRegs[io_reg::WY];
+	bool windowDrawn = false;
+	const uint8_t* vramData = this->vram->getData();
+	int next = 0;
+	for(int x = 0; x < PPU_SCREEN_WIDTH; x++)
+	{
+		while(next < this->lineWriteCount && this->lineWrites[next].dot <= PPU_FIRST_PIXEL_DOT + x)
+		{
+			lineRegs[this->lineWrites[next].reg] = this->lineWrites[next].newValue;
+			next++;
+		}
+		uint8_t lcdc = lineRegs[io_reg::LCDC];
+		uint8_t color = 0;
+		if((lcdc & 0x01) != 0)
+		{
+			if((lcdc & 0x20) != 0 && windowOnLine && x + 7 >= lineRegs[io_reg::WX])
+			{
+				uint8_t wx = x + 7 - lineRegs[io_reg::WX];
+				uint8_t entry = vramData[(((lcdc & 0x40) != 0) ? 0x1C00 : 0x1800) + (this->windowLine >> 3) * 32 + (wx >> 3)];
+				color = this->tileCache.getRow(this->bgTileIndex(lcdc, entry), this->windowLine & 0x07)[wx & 0x07];
+				windowDrawn = true;
+			}
+			else
+			{
+				uint8_t bx = x + lineRegs[io_reg::SCX];
+				uint8_t by = ly + lineRegs[io_reg::SCY];
+				uint8_t entry = vramData[(((lcdc & 0x08) != 0) ? 0x1C00 : 0x1800) + (by >> 3) * 32 + (bx >> 3)];
+				color = this->tileCache.getRow(this->bgTileIndex(lcdc, entry), by & 0x07)[bx & 0x07];
+			}
+		}
+		uint8_t shade = (lineRegs[io_reg::BGP] >> (color * 2)) & 0x03;
+		uint8_t sprite = this->spriteLine[x];
+		if((lcdc & 0x02) != 0 && sprite != 0 && ((sprite & 0x80) == 0 || color == 0))
+		{
+			uint8_t palette = lineRegs[((sprite & 0x10) != 0) ? io_reg::OBP1 : io_reg::OBP0];
+			shade = (palette >> ((sprite & 0x03) * 2)) & 0x03;
+		}
+		this->shadeLine[x] = shade;
+	}
+	if(windowDrawn)
+	{
+		this->windowLine++;
+	}
+}
 
+void PPU::renderBackground(uint8_t* regs, uint8_t ly)
+{
+	uint8_t lcdc = regs[io_reg::LCDC];
+	uint8_t y = ly + regs[io_reg::SCY];
+	uint8_t scx = regs[io_reg::SCX];
+	const uint8_t* map = this->vram->getData() + (((lcdc & 0x08) != 0) ? 0x1C00 : 0x1800) + (y >> 3) * 32;
+	//bgLine[8] is screen x 0, the first tile starts up to 7 pixels left of it. 21 tiles cover the line.
+	uint8_t* out = this->bgLine + 8 - (scx & 0x07);
+	uint8_t column = scx >> 3;
+	for(int i = 0; i < 21; i++)
+	{
+		memcpy(out + i * 8, this->tileCache.getRow(this->bgTileIndex(lcdc, map[(column + i) & 31]), y & 0x07), 8);
+	}
+}
 
+void PPU::renderWindow(uint8_t* regs, uint8_t ly)
+{
+	uint8_t lcdc = regs[io_reg::LCDC];
+	uint8_t wx = regs[io_reg::WX];
+	if(ly < regs[io_reg::WY] || wx > 166)
+	{
+		return;
+	}
+	int start = wx - 7;
+	const uint8_t* map = this->vram->getData() + (((lcdc & 0x40) != 0) ? 0x1C00 : 0x1800) + (this->windowLine >> 3) * 32;
+	uint8_t* out = this->bgLine + 8 + start;
+	int tiles = (PPU_SCREEN_WIDTH - start + 7) / 8;
+	for(int i = 0; i < tiles; i++)
+	{
+		memcpy(out + i * 8, this->tileCache.getRow(this->bgTileIndex(lcdc, map[i]), this->windowLine & 0x07), 8);
+	}
+	this->windowLine++;
+}
 
+void PPU::scanSprites(uint8_t* regs, uint8_t ly)
+{
+	const uint8_t* oam = this->oamRam->getData();
+	uint8_t height = ((regs[io_reg::LCDC] & 0x04) != 0) ? 16 : 8;
+	uint8_t count = 0;
+	const uint8_t* found = this->oamRam->getLineSprites(ly, height, &count);
+	//A higher priority sprite owns its opaque pixels even where it hides behind the background.
+	memset(this->spriteLine, 0, sizeof(this->spriteLine));
+	for(int s = 0; s < count; s++)
+	{
+		const uint8_t* sprite = oam + found[s] * 4;
+		uint8_t flags = sprite[3];
+		uint8_t row = ly - (sprite[0] - 16);
+		if((flags & 0x40) != 0)
+		{
+			row = height - 1 - row;
+		}
+		uint16_t tile = (height == 16) ? ((sprite[2] & 0xFE) + (row >> 3)) : sprite[2];
+		const uint8_t* pixels = this->tileCache.getRow(tile, row & 0x07);
+		bool flipX = (flags & 0x20) != 0;
+		int left = sprite[1] - 8;
+		for(int i = 0; i < 8; i++)
+		{
+			int x = left + i;
+			uint8_t color = pixels[flipX ? 7 - i : i];
+			if(x >= 0 && x < PPU_SCREEN_WIDTH && color != 0 && this->spriteLine[x] == 0)
+			{
+				this->spriteLine[x] = color | (flags & 0x90);
+			}
+		}
+	}
+}
 
+uint16_t PPU::bgTileIndex(uint8_t lcdc, uint8_t entry)
+{
+	if((lcdc & 0x10) != 0)
+	{
+		return entry;
+	}
+	return 256 + (int8_t)entry;
+}
 
+void PPU::writeLcdc(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue)
+{
+	PPU* ppu = (PPU*)instance;
+	uint8_t* regs = ppu->ioRam->getData();
+	ppu->logLineWrite(reg, oldValue);
+	//Switching the LCD off parks the PPU at line 0 in HBlank, switching it on starts line 0 over.
+	if((oldValue & 0x80) != 0 && (newValue & 0x80) == 0)
+	{
+		regs[io_reg::LY] = 0;
+		regs[io_reg::STAT] &= 0xFC;
+		ppu->lineDot = 0;
+		ppu->statLine = false;
+		ppu->renderFrame = false;
+	}
+	else if((oldValue & 0x80) == 0 && (newValue & 0x80) != 0)
+	{
+		regs[io_reg::LY] = 0;
+		ppu->lineDot = 0;
+		ppu->nextEventDot = 0;
+		ppu->windowLine = 0;
+		ppu->renderFrame = ppu->renderEnabled;
+		ppu->setMode(regs, GbPpu::OAM_SCAN);
+	}
+}
 
+void PPU::writeStat(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue)
+{
+	PPU* ppu = (PPU*)instance;
+	uint8_t* regs = ppu->ioRam->getData();
+	if((regs[io_reg::LCDC] & 0x80) == 0)
+	{
+		return;
+	}
+	//DMG quirk, any STAT write while the LCD is on in HBlank or VBlank raises the STAT interrupt.
+	if((oldValue & 0x02) == 0)
+	{
+		regs[io_reg::IF] |= 0x02;
+	}
+	ppu->updateStat(regs);
+}
 
+void PPU::writeLyc(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue)
+{
+	PPU* ppu = (PPU*)instance;
+	uint8_t* regs = ppu->ioRam->getData();
+	if((regs[io_reg::LCDC] & 0x80) != 0)
+	{
+		ppu->updateStat(regs);
+	}
+}
 
+void PPU::writeLineReg(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue)
+{
+	PPU* ppu = (PPU*)instance;
+	ppu->logLineWrite(reg, oldValue);
+}
 
+void PPU::logLineWrite(uint8_t reg, uint8_t oldValue)
+{
+	uint8_t* regs = this->ioRam->getData();
+	if((regs[io_reg::STAT] & 0x03) != GbPpu::DRAWING || (regs[io_reg::LCDC] & 0x80) == 0 || regs[reg] == oldValue)
+	{
+		return;
+	}
+	if(this->lineWriteCount < PPU_MAX_LINE_WRITES)
+	{
+		PpuRegWrite& write = this->lineWrites[this->lineWriteCount++];
+		write.dot = this->lineDot;
+		write.reg = reg;
+		write.oldValue = oldValue;
+		write.newValue = regs[reg];
+	}
+}
 
 /*
-<++> CHANGE::<++>()
+<++> PPU::<++>()
 {
 
 }
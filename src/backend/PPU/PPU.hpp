@@ -2,7 +2,7 @@
  *Class - PPU
  *Author - Zach Walden
  *Created - 7/22/22
- *Last Changed - 7/22/22
+ *Last Changed - 10/19/26
  *Description - Gameboy Pixel Processing Unit.
 ====================================================================================*/
 
@@ -30,6 +30,48 @@
  */
 
 
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "../IoRam/IoRam.hpp"
+#include "../SaveState/SaveState.hpp"
+#include "VRAM/VRAM.hpp"
+#include "OamRam/OamRam.hpp"
+#include "TileCache/TileCache.hpp"
+#include "PixelKernels/PixelKernels.hpp"
+#include "FrameOutput/FrameOutput.hpp"
+#include "LineOutput/LineOutput.hpp"
+
+#define PPU_SCREEN_WIDTH 160
+#define PPU_SCREEN_HEIGHT 144
+//Dots are T-cycles. A line is OAM scan, drawing, then HBlank. 10 more lines of VBlank close the frame.
+#define PPU_DOTS_PER_LINE 456
+#define PPU_OAM_SCAN_DOTS 80
+#define PPU_DRAW_DOTS 172
+#define PPU_LINES_PER_FRAME 154
+//Pixel x leaves the FIFO at about this dot plus x, after the first tile fetch.
+#define PPU_FIRST_PIXEL_DOT 92
+//A register write takes at least 8 dots, 172 dots of drawing can't log more than this.
+#define PPU_MAX_LINE_WRITES 32
+
+namespace GbPpu
+{
+enum PpuMode
+{
+	HBLANK = 0, VBLANK = 1, OAM_SCAN = 2, DRAWING = 3
+};
+}
+
+//A write to a rendering register while a line was being drawn.
+struct PpuRegWrite
+{
+	uint16_t dot;
+	uint8_t reg;
+	uint8_t oldValue;
+	uint8_t newValue;
+};
 
 class PPU
 {
@@ -37,10 +79,86 @@ class PPU
 public:
 
 private:
+	IoRam* ioRam;
+	VRAM* vram;
+	OamRam* oamRam;
+	TileCache tileCache;
+	//Cleared for frames nobody will see (run ahead, headless jobs). Timing still runs, composition is skipped.
+	//Takes effect at the next line 0.
+	bool renderEnabled = true;
+	//Position in the current line. LY and the mode live in the IO registers.
+	uint32_t lineDot = 0;
+	//Dot of the next mode change on this line. Ticks short of it return at once, 0 makes the next tick look.
+	uint32_t nextEventDot = 0;
+	//Window rows drawn this frame, the window only advances on lines it was visible.
+	uint8_t windowLine = 0;
+	//Last level of the STAT interrupt line, the interrupt fires on its rising edge.
+	bool statLine = false;
+	uint64_t frameCount = 0;
+	//Colour ids of the line being composed, with a tile of slack either side for the scroll offset.
+	uint8_t bgLine[PPU_SCREEN_WIDTH + 16];
+	uint8_t shadeLine[PPU_SCREEN_WIDTH];
+	//Winning sprite pixel per x, colour id in bits 0-1 with the OAM palette (bit 4) and behind BG (bit 7) flags. 0 = none.
+	uint8_t spriteLine[PPU_SCREEN_WIDTH];
+	//Mode 3 writes to the registers the renderer reads. Any entry sends the line down the dot renderer.
+	PpuRegWrite lineWrites[PPU_MAX_LINE_WRITES];
+	uint8_t lineWriteCount = 0;
+	bool forceDotRenderer = false;
+	uint64_t fastLines = 0;
+	uint64_t dotLines = 0;
+	//Lines are drawn into its back buffer, published at VBlank.
+	FrameOutput output;
+	//renderEnabled as it stood when this frame's line 0 started. A frame is drawn and published whole or skipped whole.
+	bool renderFrame = false;
+	//Optional, every drawn line is also queued here as it leaves mode 3.
+	LineOutput* lineOutput = nullptr;
 	//Methods
 public:
-	PPU();
+	PPU(IoRam* ioRam, VRAM* vram, OamRam* oamRam);
 	~PPU();
 
+	//Power on, line 0 at its first dot.
+	void reset();
+	//Advances the PPU by cycles T-cycles. Lines are composed whole as they leave mode 3.
+	void tick(uint32_t cycles);
+
+	void setRenderEnabled(bool enabled);
+	bool isRenderEnabled();
+	//Every line through the dot renderer, to check it against the fast path.
+	void setForceDotRenderer(bool force);
+	//Lines composed on each path since reset.
+	std::string getRenderReport();
+
+	//Shades 0-3, PPU_SCREEN_WIDTH * PPU_SCREEN_HEIGHT bytes. The last frame published, for the thread running the PPU.
+	const uint8_t* getFramebuffer();
+	//Where other threads take frames from.
+	FrameOutput* getFrameOutput();
+	//nullptr stops the per line output.
+	void setLineOutput(LineOutput* lineOutput);
+	//VBlanks since power on.
+	uint64_t getFrameCount();
+
+	//Registers and memories are saved with the arena, this is the timing state kept outside it.
+	void saveState(SaveState* state);
+	bool loadState(SaveState* state);
 private:
+	void setMode(uint8_t* regs, GbPpu::PpuMode mode);
+	void updateStat(uint8_t* regs);
+	void endLine(uint8_t* regs);
+	void renderLine(uint8_t* regs);
+	//Whole line from the registers as they stand, background and window as tile row copies.
+	void renderLineFast(uint8_t* regs, uint8_t ly);
+	//Pixel at a time, replaying the line's register writes at the dots they landed on.
+	void renderLineDots(uint8_t* regs, uint8_t ly);
+	void renderBackground(uint8_t* regs, uint8_t ly);
+	void renderWindow(uint8_t* regs, uint8_t ly);
+	void scanSprites(uint8_t* regs, uint8_t ly);
+	//Tile cache index for a map entry, LCDC bit 4 picks unsigned from 0x8000 or signed from 0x9000.
+	uint16_t bgTileIndex(uint8_t lcdc, uint8_t entry);
+	static void writeLcdc(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue);
+	static void writeStat(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue);
+	static void writeLyc(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue);
+	//SCY, SCX, BGP, OBP0, OBP1, WY and WX only matter if they change mid line.
+	static void writeLineReg(void* instance, uint8_t reg, uint8_t oldValue, uint8_t newValue);
+	void logLineWrite(uint8_t reg, uint8_t oldValue);
 };
@@ -0,0 +1,450 @@
+/*==================================================================================
+ *Class - PixelKernels
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Bulk pixel loops, 2bpp row decode, palette mapping and shade to colour expansion. Scalar, SSE2 and AVX2 versions chosen at run time.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <cstring>
+
+#include "PixelKernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PIXEL_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+struct KernelTable
+{
+	GbSimd::SimdLevel level;
+	void (*decodeRows)(const uint8_t*, uint8_t*, size_t);
+	void (*mapPalette)(const uint8_t*, uint8_t, uint8_t*, size_t);
+	void (*expandShades)(const uint8_t*, const uint32_t*, uint32_t*, size_t);
+	void (*expandShades16)(const uint8_t*, const uint16_t*, uint16_t*, size_t);
+	void (*expandShades8)(const uint8_t*, const uint8_t*, uint8_t*, size_t);
+	void (*expandShades24)(const uint8_t*, const uint32_t*, uint8_t*, size_t);
+};
+
+void decodeRowsScalar(const uint8_t* planes, uint8_t* out, size_t rows)
+{
+	for(size_t row = 0; row < rows; row++)
+	{
+		uint8_t low = planes[row * 2];
+		uint8_t high = planes[row * 2 + 1];
+		for(int x = 0; x < 8; x++)
+		{
+			out[row * 8 + x] = ((low >> (7 - x)) & 0x01) | (((high >> (7 - x)) & 0x01) << 1);
+		}
+	}
+}
+
+void mapPaletteScalar(const uint8_t* ids, uint8_t palette, uint8_t* out, size_t count)
+{
+	uint8_t shades[4] = {(uint8_t)(palette & 0x03), (uint8_t)((palette >> 2) & 0x03), (uint8_t)((palette >> 4) & 0x03), (uint8_t)((palette >> 6) & 0x03)};
+	for(size_t i = 0; i < count; i++)
+	{
+		out[i] = shades[ids[i] & 0x03];
+	}
+}
+
+void expandShadesScalar(const uint8_t* shades, const uint32_t* colors, uint32_t* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		out[i] = colors[shades[i] & 0x03];
+	}
+}
+
+void expandShades16Scalar(const uint8_t* shades, const uint16_t* colors, uint16_t* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		out[i] = colors[shades[i] & 0x03];
+	}
+}
+
+void expandShades8Scalar(const uint8_t* shades, const uint8_t* colors, uint8_t* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		out[i] = colors[shades[i] & 0x03];
+	}
+}
+
+void expandShades24Scalar(const uint8_t* shades, const uint32_t* colors, uint8_t* out, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		uint32_t color = colors[shades[i] & 0x03];
+		out[i * 3] = color & 0xFF;
+		out[i * 3 + 1] = (color >> 8) & 0xFF;
+		out[i * 3 + 2] = (color >> 16) & 0xFF;
+	}
+}
+
+#ifdef PIXEL_KERNELS_X86
+
+//Splits one row's planes, [low x8 | high x8], into 8 ids in the low half.
+__attribute__((target("sse2"))) inline __m128i decodeRowSse2(__m128i planes)
+{
+	const __m128i bits = _mm_set_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, (char)0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, (char)0x80);
+	const __m128i weights = _mm_set_epi8(2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1);
+	__m128i set = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(planes, bits), bits), weights);
+	return _mm_or_si128(set, _mm_srli_si128(set, 8));
+}
+
+__attribute__((target("sse2"))) void decodeRowsSse2(const uint8_t* planes, uint8_t* out, size_t rows)
+{
+	size_t row = 0;
+	//4 rows per 8 byte load. Byte doubling three times turns [l0 h0 l1 h1 ..] into [l0 x8 | h0 x8] per row.
+	for(; row + 4 <= rows; row += 4)
+	{
+		__m128i bytes = _mm_loadl_epi64((const __m128i*)(planes + row * 2));
+		__m128i pairs = _mm_unpacklo_epi8(bytes, bytes);
+		__m128i front = _mm_unpacklo_epi16(pairs, pairs);
+		__m128i back = _mm_unpackhi_epi16(pairs, pairs);
+		_mm_storel_epi64((__m128i*)(out + row * 8), decodeRowSse2(_mm_unpacklo_epi32(front, front)));
+		_mm_storel_epi64((__m128i*)(out + row * 8 + 8), decodeRowSse2(_mm_unpackhi_epi32(front, front)));
+		_mm_storel_epi64((__m128i*)(out + row * 8 + 16), decodeRowSse2(_mm_unpacklo_epi32(back, back)));
+		_mm_storel_epi64((__m128i*)(out + row * 8 + 24), decodeRowSse2(_mm_unpackhi_epi32(back, back)));
+	}
+	decodeRowsScalar(planes + row * 2, out + row * 8, rows - row);
+}
+
+__attribute__((target("sse2"))) void mapPaletteSse2(const uint8_t* ids, uint8_t palette, uint8_t* out, size_t count)
+{
+	//No byte shuffle in SSE2, select each of the 4 shades by compare.
+	__m128i shade[4];
+	__m128i id[4];
+	for(int i = 0; i < 4; i++)
+	{
+		shade[i] = _mm_set1_epi8((palette >> (i * 2)) & 0x03);
+		id[i] = _mm_set1_epi8(i);
+	}
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(ids + i));
+		__m128i r = _mm_and_si128(_mm_cmpeq_epi8(v, id[0]), shade[0]);
+		r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi8(v, id[1]), shade[1]));
+		r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi8(v, id[2]), shade[2]));
+		r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi8(v, id[3]), shade[3]));
+		_mm_storeu_si128((__m128i*)(out + i), r);
+	}
+	mapPaletteScalar(ids + i, palette, out + i, count - i);
+}
+
+__attribute__((target("sse2"))) inline __m128i selectColorSse2(__m128i shades, const __m128i* id, const __m128i* color)
+{
+	__m128i r = _mm_and_si128(_mm_cmpeq_epi32(shades, id[0]), color[0]);
+	r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi32(shades, id[1]), color[1]));
+	r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi32(shades, id[2]), color[2]));
+	return _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi32(shades, id[3]), color[3]));
+}
+
+__attribute__((target("sse2"))) void expandShadesSse2(const uint8_t* shades, const uint32_t* colors, uint32_t* out, size_t count)
+{
+	__m128i id[4];
+	__m128i color[4];
+	for(int i = 0; i < 4; i++)
+	{
+		id[i] = _mm_set1_epi32(i);
+		color[i] = _mm_set1_epi32(colors[i]);
+	}
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(shades + i));
+		__m128i low = _mm_unpacklo_epi8(v, zero);
+		__m128i high = _mm_unpackhi_epi8(v, zero);
+		_mm_storeu_si128((__m128i*)(out + i), selectColorSse2(_mm_unpacklo_epi16(low, zero), id, color));
+		_mm_storeu_si128((__m128i*)(out + i + 4), selectColorSse2(_mm_unpackhi_epi16(low, zero), id, color));
+		_mm_storeu_si128((__m128i*)(out + i + 8), selectColorSse2(_mm_unpacklo_epi16(high, zero), id, color));
+		_mm_storeu_si128((__m128i*)(out + i + 12), selectColorSse2(_mm_unpackhi_epi16(high, zero), id, color));
+	}
+	expandShadesScalar(shades + i, colors, out + i, count - i);
+}
+
+__attribute__((target("sse2"))) void expandShades16Sse2(const uint8_t* shades, const uint16_t* colors, uint16_t* out, size_t count)
+{
+	__m128i id[4];
+	__m128i color[4];
+	for(int i = 0; i < 4; i++)
+	{
+		id[i] = _mm_set1_epi16(i);
+		color[i] = _mm_set1_epi16(colors[i]);
+	}
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(shades + i));
+		__m128i half[2] = {_mm_unpacklo_epi8(v, zero), _mm_unpackhi_epi8(v, zero)};
+		for(int h = 0; h < 2; h++)
+		{
+			__m128i r = _mm_and_si128(_mm_cmpeq_epi16(half[h], id[0]), color[0]);
+			r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi16(half[h], id[1]), color[1]));
+			r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi16(half[h], id[2]), color[2]));
+			r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi16(half[h], id[3]), color[3]));
+			_mm_storeu_si128((__m128i*)(out + i + h * 8), r);
+		}
+	}
+	expandShades16Scalar(shades + i, colors, out + i, count - i);
+}
+
+__attribute__((target("sse2"))) void expandShades8Sse2(const uint8_t* shades, const uint8_t* colors, uint8_t* out, size_t count)
+{
+	__m128i id[4];
+	__m128i color[4];
+	for(int i = 0; i < 4; i++)
+	{
+		id[i] = _mm_set1_epi8(i);
+		color[i] = _mm_set1_epi8(colors[i]);
+	}
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(shades + i));
+		__m128i r = _mm_and_si128(_mm_cmpeq_epi8(v, id[0]), color[0]);
+		r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi8(v, id[1]), color[1]));
+		r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi8(v, id[2]), color[2]));
+		r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi8(v, id[3]), color[3]));
+		_mm_storeu_si128((__m128i*)(out + i), r);
+	}
+	expandShades8Scalar(shades + i, colors, out + i, count - i);
+}
+
+__attribute__((target("avx2"))) void decodeRowsAvx2(const uint8_t* planes, uint8_t* out, size_t rows)
+{
+	const __m256i bits = _mm256_set1_epi64x(0x0102040810204080LL);
+	const __m256i weights = _mm256_set_epi64x(0x0202020202020202LL, 0x0101010101010101LL, 0x0202020202020202LL, 0x0101010101010101LL);
+	//Each 128 bit lane builds [low x8 | high x8] for one row, a shuffle per row pair.
+	__m256i spread[4];
+	for(int pair = 0; pair < 4; pair++)
+	{
+		char r0 = pair * 4;
+		char r1 = pair * 4 + 2;
+		spread[pair] = _mm256_setr_epi8(r0, r0, r0, r0, r0, r0, r0, r0, r0 + 1, r0 + 1, r0 + 1, r0 + 1, r0 + 1, r0 + 1, r0 + 1, r0 + 1,
+			r1, r1, r1, r1, r1, r1, r1, r1, r1 + 1, r1 + 1, r1 + 1, r1 + 1, r1 + 1, r1 + 1, r1 + 1, r1 + 1);
+	}
+	size_t row = 0;
+	for(; row + 8 <= rows; row += 8)
+	{
+		__m256i bytes = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(planes + row * 2)));
+		for(int pair = 0; pair < 4; pair++)
+		{
+			__m256i v = _mm256_shuffle_epi8(bytes, spread[pair]);
+			__m256i set = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(v, bits), bits), weights);
+			set = _mm256_or_si256(set, _mm256_srli_si256(set, 8));
+			//Row ids sit in quadwords 0 and 2.
+			_mm_storeu_si128((__m128i*)(out + row * 8 + pair * 16), _mm256_castsi256_si128(_mm256_permute4x64_epi64(set, 0x08)));
+		}
+	}
+	decodeRowsScalar(planes + row * 2, out + row * 8, rows - row);
+}
+
+__attribute__((target("avx2"))) void mapPaletteAvx2(const uint8_t* ids, uint8_t palette, uint8_t* out, size_t count)
+{
+	__m256i table = _mm256_setr_epi8(palette & 0x03, (palette >> 2) & 0x03, (palette >> 4) & 0x03, (palette >> 6) & 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		palette & 0x03, (palette >> 2) & 0x03, (palette >> 4) & 0x03, (palette >> 6) & 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	size_t i = 0;
+	for(; i + 32 <= count; i += 32)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i*)(ids + i));
+		_mm256_storeu_si256((__m256i*)(out + i), _mm256_shuffle_epi8(table, v));
+	}
+	mapPaletteScalar(ids + i, palette, out + i, count - i);
+}
+
+__attribute__((target("avx2"))) void expandShadesAvx2(const uint8_t* shades, const uint32_t* colors, uint32_t* out, size_t count)
+{
+	__m256i table = _mm256_setr_epi32(colors[0], colors[1], colors[2], colors[3], 0, 0, 0, 0);
+	size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(shades + i)));
+		_mm256_storeu_si256((__m256i*)(out + i), _mm256_permutevar8x32_epi32(table, index));
+	}
+	expandShadesScalar(shades + i, colors, out + i, count - i);
+}
+
+__attribute__((target("avx2"))) void expandShades16Avx2(const uint8_t* shades, const uint16_t* colors, uint16_t* out, size_t count)
+{
+	//Low and high bytes looked up separately, then interleaved back into 16 bit pixels.
+	__m256i low = _mm256_setr_epi8(colors[0] & 0xFF, colors[1] & 0xFF, colors[2] & 0xFF, colors[3] & 0xFF, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		colors[0] & 0xFF, colors[1] & 0xFF, colors[2] & 0xFF, colors[3] & 0xFF, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	__m256i high = _mm256_setr_epi8(colors[0] >> 8, colors[1] >> 8, colors[2] >> 8, colors[3] >> 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		colors[0] >> 8, colors[1] >> 8, colors[2] >> 8, colors[3] >> 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	size_t i = 0;
+	for(; i + 32 <= count; i += 32)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i*)(shades + i));
+		__m256i l = _mm256_shuffle_epi8(low, v);
+		__m256i h = _mm256_shuffle_epi8(high, v);
+		//Unpacks stay inside each 128 bit lane, put the lanes back in pixel order.
+		__m256i a = _mm256_unpacklo_epi8(l, h);
+		__m256i b = _mm256_unpackhi_epi8(l, h);
+		_mm256_storeu_si256((__m256i*)(out + i), _mm256_permute2x128_si256(a, b, 0x20));
+		_mm256_storeu_si256((__m256i*)(out + i + 16), _mm256_permute2x128_si256(a, b, 0x31));
+	}
+	expandShades16Scalar(shades + i, colors, out + i, count - i);
+}
+
+__attribute__((target("avx2"))) void expandShades8Avx2(const uint8_t* shades, const uint8_t* colors, uint8_t* out, size_t count)
+{
+	__m256i table = _mm256_setr_epi8(colors[0], colors[1], colors[2], colors[3], 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		colors[0], colors[1], colors[2], colors[3], 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	size_t i = 0;
+	for(; i + 32 <= count; i += 32)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i*)(shades + i));
+		_mm256_storeu_si256((__m256i*)(out + i), _mm256_shuffle_epi8(table, v));
+	}
+	expandShades8Scalar(shades + i, colors, out + i, count - i);
+}
+
+__attribute__((target("avx2"))) void expandShades24Avx2(const uint8_t* shades, const uint32_t* colors, uint8_t* out, size_t count)
+{
+	__m256i table = _mm256_setr_epi32(colors[0], colors[1], colors[2], colors[3], 0, 0, 0, 0);
+	//Drops every fourth byte, 12 packed bytes at the bottom of each lane.
+	const __m256i pack = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	size_t i = 0;
+	//Each lane store writes 4 bytes past its 12, the next group overwrites them. Stop while that still lands inside the output.
+	for(; i + 10 <= count; i += 8)
+	{
+		__m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(shades + i)));
+		__m256i packed = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(table, index), pack);
+		_mm_storeu_si128((__m128i*)(out + i * 3), _mm256_castsi256_si128(packed));
+		_mm_storeu_si128((__m128i*)(out + i * 3 + 12), _mm256_extracti128_si256(packed, 1));
+	}
+	expandShades24Scalar(shades + i, colors, out + i * 3, count - i);
+}
+
+#endif
+
+const KernelTable scalarKernels = {GbSimd::SCALAR, &decodeRowsScalar, &mapPaletteScalar, &expandShadesScalar, &expandShades16Scalar, &expandShades8Scalar, &expandShades24Scalar};
+#ifdef PIXEL_KERNELS_X86
+//SSE2 has no byte shuffle to pack 3 byte pixels, RGB888 stays scalar there.
+const KernelTable sse2Kernels = {GbSimd::SSE2, &decodeRowsSse2, &mapPaletteSse2, &expandShadesSse2, &expandShades16Sse2, &expandShades8Sse2, &expandShades24Scalar};
+const KernelTable avx2Kernels = {GbSimd::AVX2, &decodeRowsAvx2, &mapPaletteAvx2, &expandShadesAvx2, &expandShades16Avx2, &expandShades8Avx2, &expandShades24Avx2};
+#endif
+
+GbSimd::SimdLevel supportedLevel()
+{
+#ifdef PIXEL_KERNELS_X86
+	if(__builtin_cpu_supports("avx2"))
+	{
+		return GbSimd::AVX2;
+	}
+	if(__builtin_cpu_supports("sse2"))
+	{
+		return GbSimd::SSE2;
+	}
+#endif
+	return GbSimd::SCALAR;
+}
+
+const KernelTable* tableFor(GbSimd::SimdLevel level)
+{
+#ifdef PIXEL_KERNELS_X86
+	if(level == GbSimd::AVX2)
+	{
+		return &avx2Kernels;
+	}
+	if(level == GbSimd::SSE2)
+	{
+		return &sse2Kernels;
+	}
+#endif
+	return &scalarKernels;
+}
+
+//Chosen during static initialisation, before any emulator thread exists.
+const KernelTable* kernels = tableFor(supportedLevel());
+
+}
+
+void PixelKernels::decodeRows(const uint8_t* planes, uint8_t* out, size_t rows)
+{
+	kernels->decodeRows(planes, out, rows);
+}
+
+void PixelKernels::mapPalette(const uint8_t* ids, uint8_t palette, uint8_t* out, size_t count)
+{
+	kernels->mapPalette(ids, palette, out, count);
+}
+
+void PixelKernels::expandShades(const uint8_t* shades, const uint32_t* colors, uint32_t* out, size_t count)
+{
+	kernels->expandShades(shades, colors, out, count);
+}
+
+void PixelKernels::expandShades16(const uint8_t* shades, const uint16_t* colors, uint16_t* out, size_t count)
+{
+	kernels->expandShades16(shades, colors, out, count);
+}
+
+void PixelKernels::expandShades8(const uint8_t* shades, const uint8_t* colors, uint8_t* out, size_t count)
+{
+	kernels->expandShades8(shades, colors, out, count);
+}
+
+void PixelKernels::expandShades24(const uint8_t* shades, const uint32_t* colors, uint8_t* out, size_t count)
+{
+	kernels->expandShades24(shades, colors, out, count);
+}
+
+void PixelKernels::setLevel(GbSimd::SimdLevel level)
+{
+	GbSimd::SimdLevel supported = supportedLevel();
+	kernels = tableFor((level < supported) ? level : supported);
+}
+
+GbSimd::SimdLevel PixelKernels::getLevel()
+{
+	return kernels->level;
+}
+
+const char* PixelKernels::getLevelName()
+{
+	static const char* names[3] = {"scalar", "SSE2", "AVX2"};
+	return names[kernels->level];
+}
+
+/*
+<++> PixelKernels::<++>()
+{
+
+}
+*/
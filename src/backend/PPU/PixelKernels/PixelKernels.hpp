@@ -0,0 +1,72 @@
+/*==================================================================================
+ *Class - PixelKernels
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Bulk pixel loops, 2bpp row decode, palette mapping and shade to colour expansion. Scalar, SSE2 and AVX2 versions chosen at run time.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace GbSimd
+{
+enum SimdLevel
+{
+	SCALAR, SSE2, AVX2
+};
+}
+
+class PixelKernels
+{
+	//Attributes
+public:
+
+private:
+
+	//Methods
+public:
+	//rows tile rows, 2 bitplane bytes each as they sit in VRAM, to 8 colour ids (0-3) per row, leftmost pixel first.
+	static void decodeRows(const uint8_t* planes, uint8_t* out, size_t rows);
+	//Colour ids through a DMG palette register (BGP, OBP0, OBP1) to shades 0-3.
+	static void mapPalette(const uint8_t* ids, uint8_t palette, uint8_t* out, size_t count);
+	//Shades 0-3 to host colours through a 4 entry table.
+	static void expandShades(const uint8_t* shades, const uint32_t* colors, uint32_t* out, size_t count);
+	//The same for 16 bit (RGB565) and 8 bit (grey) formats.
+	static void expandShades16(const uint8_t* shades, const uint16_t* colors, uint16_t* out, size_t count);
+	static void expandShades8(const uint8_t* shades, const uint8_t* colors, uint8_t* out, size_t count);
+	//Packed 3 byte pixels, colors as RGBA8888 with the alpha byte dropped.
+	static void expandShades24(const uint8_t* shades, const uint32_t* colors, uint8_t* out, size_t count);
+
+	//Best level the host supports is picked at start up. Asking for more than it supports gets the best it has.
+	static void setLevel(GbSimd::SimdLevel level);
+	static GbSimd::SimdLevel getLevel();
+	static const char* getLevelName();
+private:
+};
@@ -0,0 +1,81 @@
+/*==================================================================================
+ *Class - TileCache
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Tiles decoded from 2bpp to one colour id per byte, refreshed from VRAM's dirty bits so line composition only copies bytes.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <cstring>
+
+#include "TileCache.hpp"
+#include "../PixelKernels/PixelKernels.hpp"
+
+TileCache::TileCache()
+{
+	memset(this->tiles, 0, sizeof(this->tiles));
+}
+
+TileCache::~TileCache()
+{
+
+}
+
+void TileCache::update(VRAM* vram)
+{
+	uint64_t* dirty = vram->getDirtyTiles();
+	const uint8_t* data = vram->getData();
+	for(int word = 0; word < VRAM_TILE_WORDS; word++)
+	{
+		uint64_t bits = dirty[word];
+		dirty[word] = 0;
+		//Runs of dirty tiles are contiguous on both sides, each run is one kernel call.
+		while(bits != 0)
+		{
+			int first = __builtin_ctzll(bits);
+			uint64_t run = bits >> first;
+			int length = (~run == 0) ? 64 - first : __builtin_ctzll(~run);
+			int tile = (word << 6) + first;
+			PixelKernels::decodeRows(data + tile * TILE_BYTES, this->tiles[tile], length * 8);
+			bits = (first + length >= 64) ? 0 : bits & ~(((1ULL << length) - 1) << first);
+		}
+	}
+}
+
+const uint8_t* TileCache::getRow(uint16_t tile, uint8_t row)
+{
+	return &this->tiles[tile][row << 3];
+}
+
+/*
+<++> TileCache::<++>()
+{
+
+}
+*/
@@ -0,0 +1,60 @@
+/*==================================================================================
+ *Class - TileCache
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Tiles decoded from 2bpp to one colour id per byte, refreshed from VRAM's dirty bits so line composition only copies bytes.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "../VRAM/VRAM.hpp"
+
+#define TILE_BYTES 16
+#define TILE_PIXELS 64
+
+class TileCache
+{
+	//Attributes
+public:
+
+private:
+	//Row major, 8 bytes per row, values 0-3.
+	alignas(64) uint8_t tiles[VRAM_TILE_COUNT][TILE_PIXELS];
+	//Methods
+public:
+	TileCache();
+	~TileCache();
+
+	//Decodes every tile VRAM has marked dirty and clears the marks.
+	void update(VRAM* vram);
+	//Row of a tile, tile is the 0-383 index from 0x8000.
+	const uint8_t* getRow(uint16_t tile, uint8_t row);
+private:
+};
@@ -1,9 +1,9 @@
 /*==================================================================================
  *Class - VRAM
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Video Ram 0x8000 -> 0x9FFF
 ====================================================================================*/
 
 /*
@@ -33,22 +33,55 @@
 
 #include "VRAM.hpp"
 
+VRAM::VRAM()
+{
+	this->markAllDirty();
+}
 
+VRAM::~VRAM()
+{
 
+}
 
+uint8_t VRAM::read(uint16_t address)
+{
+	return this->vram[address & 0x1FFF];
+}
 
+void VRAM::write(uint16_t address, uint8_t value)
+{
+	uint16_t offset = address & 0x1FFF;
+	this->vram[offset] = value;
+	if(offset < VRAM_TILE_DATA_SIZE)
+	{
+		uint16_t tile = offset >> 4;
+		this->dirtyTiles[tile >> 6] |= 1ULL << (tile & 63);
+	}
+}
 
+void VRAM::attach(uint8_t* memory)
+{
+	this->vram = memory;
+	this->markAllDirty();
+}
 
+uint8_t* VRAM::getData()
+{
+	return this->vram;
+}
 
+void VRAM::markAllDirty()
+{
+	for(int i = 0; i < VRAM_TILE_WORDS; i++)
+	{
+		this->dirtyTiles[i] = ~0ULL;
+	}
+}
 
-
-
-
-
-
-
-
-
+uint64_t* VRAM::getDirtyTiles()
+{
+	return this->dirtyTiles;
+}
 
 
 /*
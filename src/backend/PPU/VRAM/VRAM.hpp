@@ -1,9 +1,9 @@
 /*==================================================================================
  *Class - VRAM
  *Author - Zach Walden
- *Created -
- *Last Changed -
- *Description -
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Video Ram 0x8000 -> 0x9FFF
 ====================================================================================*/
 
 /*
@@ -29,7 +29,15 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#pragma once
 
+#include <cstdint>
+
+#define VRAM_SIZE 8192
+//Tile data is 0x8000-0x97FF, 384 tiles of 16 bytes. Writes past it are the tile maps.
+#define VRAM_TILE_DATA_SIZE 0x1800
+#define VRAM_TILE_COUNT 384
+#define VRAM_TILE_WORDS 6
 
 class VRAM
 {
@@ -37,10 +45,23 @@ class VRAM
 public:
 
 private:
+	uint8_t* vram = nullptr;
+	//One bit per tile written since the tile cache last looked.
+	uint64_t dirtyTiles[VRAM_TILE_WORDS];
 	//Methods
 public:
 	VRAM();
 	~VRAM();
 
+	uint8_t read(uint16_t address);
+	void write(uint16_t address, uint8_t value);
+
+	//Points the memory at its region of the arena, VRAM_SIZE bytes.
+	void attach(uint8_t* memory);
+	uint8_t* getData();
+
+	//Anything that writes tile data without going through write (state loads, the fast boot logo) must call this.
+	void markAllDirty();
+	uint64_t* getDirtyTiles();
 private:
 };
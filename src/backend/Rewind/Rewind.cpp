@@ -0,0 +1,312 @@
+/*==================================================================================
+ *Class - Rewind
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Rewind history. Keeps the newest state whole and a ring of XOR/RLE deltas stepping back to each older state.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include "Rewind.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+Rewind::Rewind(GameBoy* gb, size_t capacity, uint32_t interval)
+{
+	this->gb = gb;
+	this->ring.resize(capacity > 0 ? capacity : 1);
+	this->interval = interval > 0 ? interval : 1;
+}
+
+Rewind::~Rewind()
+{
+
+}
+
+void Rewind::frameCompleted()
+{
+	this->frameCounter++;
+	if(this->frameCounter >= this->interval)
+	{
+		this->frameCounter = 0;
+		this->record();
+	}
+}
+
+size_t Rewind::rewindEntries(size_t entries)
+{
+	if(!this->haveState)
+	{
+		return 0;
+	}
+	SaveState* state = &this->states[this->current];
+	size_t stepped = 0;
+	//Each delta is newer XOR older, applying it to the newest state yields the one before it.
+	while(stepped < entries && this->count > 0)
+	{
+		this->head = (this->head + this->ring.size() - 1) % this->ring.size();
+		RewindEntry* entry = &this->ring[this->head];
+		applyDelta(entry->delta.data(), entry->size, state->getData(), state->getSize());
+		this->deltaBytes -= entry->size;
+		entry->size = 0;
+		this->count--;
+		stepped++;
+	}
+	//A state the GameBoy turns away (another rom loaded since) leaves the history unusable, the steps taken can't be undone.
+	if(!this->gb->restoreState(state))
+	{
+		this->clear();
+		return 0;
+	}
+	this->frameCounter = 0;
+	return stepped;
+}
+
+size_t Rewind::rewindFrames(uint32_t frames)
+{
+	return this->rewindEntries((frames + this->interval - 1) / this->interval);
+}
+
+void Rewind::clear()
+{
+	for(RewindEntry& entry : this->ring)
+	{
+		entry.size = 0;
+	}
+	this->head = 0;
+	this->count = 0;
+	this->deltaBytes = 0;
+	this->frameCounter = 0;
+	this->haveState = false;
+}
+
+size_t Rewind::getEntryCount()
+{
+	return this->count;
+}
+
+size_t Rewind::getMemoryUsage()
+{
+	size_t total = this->states[0].getCapacity() + this->states[1].getCapacity() + this->diff.capacity();
+	for(RewindEntry& entry : this->ring)
+	{
+		total += entry.delta.capacity();
+	}
+	return total;
+}
+
+size_t Rewind::getBytesPerMinute()
+{
+	if(this->count == 0)
+	{
+		return 0;
+	}
+	return (this->deltaBytes / this->count) * (REWIND_FRAMES_PER_MINUTE / this->interval);
+}
+
+void Rewind::record()
+{
+	uint8_t next = this->current ^ 1;
+	SaveState* newState = &this->states[next];
+	SaveState* oldState = &this->states[this->current];
+	this->gb->captureState(newState);
+	//A state of a different size means a different rom, the old history no longer applies.
+	if(!this->haveState || newState->getSize() != oldState->getSize())
+	{
+		this->clear();
+		this->current = next;
+		this->haveState = true;
+		return;
+	}
+	size_t length = newState->getSize();
+	if(this->diff.size() < length)
+	{
+		this->diff.resize(length);
+	}
+	xorBlocks(newState->getData(), oldState->getData(), this->diff.data(), length);
+	RewindEntry* entry = &this->ring[this->head];
+	//Overwriting the oldest entry drops the oldest reachable state.
+	if(this->count == this->ring.size())
+	{
+		this->deltaBytes -= entry->size;
+		this->count--;
+	}
+	entry->size = encodeDelta(this->diff.data(), length, entry->delta);
+	this->deltaBytes += entry->size;
+	this->head = (this->head + 1) % this->ring.size();
+	this->count++;
+	this->current = next;
+}
+
+void Rewind::xorBlocks(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t length)
+{
+	size_t i = 0;
+#if defined(__SSE2__)
+	for(; i + 16 <= length; i += 16)
+	{
+		__m128i blockA = _mm_loadu_si128((const __m128i*)(a + i));
+		__m128i blockB = _mm_loadu_si128((const __m128i*)(b + i));
+		_mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(blockA, blockB));
+	}
+#endif
+	for(; i < length; i++)
+	{
+		out[i] = a[i] ^ b[i];
+	}
+}
+
+size_t Rewind::skipZeros(const uint8_t* data, size_t index, size_t length)
+{
+#if defined(__SSE2__)
+	//Most of a frame's diff is zero, skip it a block at a time.
+	const __m128i zero = _mm_setzero_si128();
+	while(index + 16 <= length)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i*)(data + index));
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, zero));
+		if(mask != 0xFFFF)
+		{
+			return index + __builtin_ctz(~mask);
+		}
+		index += 16;
+	}
+#endif
+	while(index < length && data[index] == 0)
+	{
+		index++;
+	}
+	return index;
+}
+
+//Delta format, repeated till the end of the delta: varint zero run, varint literal length, literal bytes.
+//Trailing zeros are not stored.
+size_t Rewind::encodeDelta(const uint8_t* diff, size_t length, std::vector<uint8_t>& out)
+{
+	//Worst case is a literal broken up by every minimum zero run, reserve that once.
+	size_t worstCase = length + (length / REWIND_MIN_ZERO_RUN) * 2 + 20;
+	if(out.size() < worstCase)
+	{
+		out.resize(worstCase);
+	}
+	uint8_t* dst = out.data();
+	size_t outPos = 0;
+	size_t i = 0;
+	while(i < length)
+	{
+		size_t zeroStart = i;
+		i = skipZeros(diff, i, length);
+		if(i >= length)
+		{
+			break;
+		}
+		size_t literalStart = i;
+		size_t literalEnd = i;
+		size_t j = i;
+		while(j < length)
+		{
+			if(diff[j] != 0)
+			{
+				literalEnd = j + 1;
+			}
+			else if(j - literalEnd + 1 >= REWIND_MIN_ZERO_RUN)
+			{
+				break;
+			}
+			j++;
+		}
+		outPos += writeVarint(dst + outPos, literalStart - zeroStart);
+		outPos += writeVarint(dst + outPos, literalEnd - literalStart);
+		std::memcpy(dst + outPos, diff + literalStart, literalEnd - literalStart);
+		outPos += literalEnd - literalStart;
+		i = literalEnd;
+	}
+	return outPos;
+}
+
+void Rewind::applyDelta(const uint8_t* delta, size_t deltaLength, uint8_t* state, size_t length)
+{
+	size_t inPos = 0;
+	size_t statePos = 0;
+	while(inPos < deltaLength)
+	{
+		size_t zeroRun, literalLength;
+		inPos += readVarint(delta + inPos, deltaLength - inPos, zeroRun);
+		inPos += readVarint(delta + inPos, deltaLength - inPos, literalLength);
+		statePos += zeroRun;
+		if(statePos + literalLength > length || inPos + literalLength > deltaLength)
+		{
+			return;
+		}
+		for(size_t k = 0; k < literalLength; k++)
+		{
+			state[statePos + k] ^= delta[inPos + k];
+		}
+		statePos += literalLength;
+		inPos += literalLength;
+	}
+}
+
+size_t Rewind::writeVarint(uint8_t* out, size_t value)
+{
+	size_t bytes = 0;
+	while(value >= 0x80)
+	{
+		out[bytes++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	out[bytes++] = (uint8_t)value;
+	return bytes;
+}
+
+size_t Rewind::readVarint(const uint8_t* in, size_t inLength, size_t& value)
+{
+	size_t bytes = 0;
+	unsigned shift = 0;
+	value = 0;
+	while(bytes < inLength)
+	{
+		uint8_t byte = in[bytes++];
+		value |= (size_t)(byte & 0x7F) << shift;
+		if((byte & 0x80) == 0)
+		{
+			break;
+		}
+		shift += 7;
+	}
+	return bytes;
+}
+
+/*
+<++> Rewind::<++>()
+{
+
+}
+*/
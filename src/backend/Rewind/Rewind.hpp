@@ -0,0 +1,100 @@
+/*==================================================================================
+ *Class - Rewind
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Rewind history. Keeps the newest state whole and a ring of XOR/RLE deltas stepping back to each older state.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "../GameBoy.hpp"
+#include "../SaveState/SaveState.hpp"
+
+//60 frames a second
+#define REWIND_FRAMES_PER_MINUTE 3600
+//Zero runs shorter than this stay inside the literal, stops the token overhead from outgrowing the bytes saved.
+#define REWIND_MIN_ZERO_RUN 4
+
+struct RewindEntry
+{
+	//Keeps its capacity when the ring wraps, so steady state recording does not allocate.
+	std::vector<uint8_t> delta;
+	size_t size = 0;
+};
+
+class Rewind
+{
+	//Attributes
+public:
+
+private:
+	GameBoy* gb;
+	std::vector<RewindEntry> ring;
+	size_t head = 0;
+	size_t count = 0;
+	//Frames between recorded states.
+	uint32_t interval;
+	uint32_t frameCounter = 0;
+	//states[current] is the newest recorded state, the other is scratch for the next capture.
+	SaveState states[2];
+	uint8_t current = 0;
+	bool haveState = false;
+	std::vector<uint8_t> diff;
+	//Sum of the live delta sizes.
+	size_t deltaBytes = 0;
+	//Methods
+public:
+	Rewind(GameBoy* gb, size_t capacity, uint32_t interval);
+	~Rewind();
+
+	//Call once per emulated frame, records a state every interval frames.
+	void frameCompleted();
+	//Steps back through the history and restores the GameBoy to the state reached. Returns the number of entries stepped back,
+	//0 with the history cleared if the GameBoy rejects the state.
+	size_t rewindEntries(size_t entries);
+	size_t rewindFrames(uint32_t frames);
+	void clear();
+
+	size_t getEntryCount();
+	//Bytes held by the ring, the newest state and scratch buffers.
+	size_t getMemoryUsage();
+	//Average delta size scaled to one minute of history at the current interval.
+	size_t getBytesPerMinute();
+private:
+	void record();
+
+	static void xorBlocks(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t length);
+	static size_t skipZeros(const uint8_t* data, size_t index, size_t length);
+	static size_t encodeDelta(const uint8_t* diff, size_t length, std::vector<uint8_t>& out);
+	static void applyDelta(const uint8_t* delta, size_t deltaLength, uint8_t* state, size_t length);
+	static size_t writeVarint(uint8_t* out, size_t value);
+	static size_t readVarint(const uint8_t* in, size_t inLength, size_t& value);
+};
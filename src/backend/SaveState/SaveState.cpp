@@ -0,0 +1,156 @@
+/*==================================================================================
+ *Class - SaveState
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Flat serialized machine state. Components append their state in a fixed order, so two states of the same rom are always the same size.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include "SaveState.hpp"
+
+#include <cstring>
+#include <fstream>
+
+SaveState::SaveState()
+{
+
+}
+
+SaveState::~SaveState()
+{
+
+}
+
+void SaveState::clear()
+{
+	this->size = 0;
+	this->position = 0;
+}
+
+void SaveState::rewind()
+{
+	this->position = 0;
+}
+
+void SaveState::writeBlock(const void* src, size_t length)
+{
+	if(this->size + length > this->data.size())
+	{
+		this->data.resize(this->size + length);
+	}
+	std::memcpy(this->data.data() + this->size, src, length);
+	this->size += length;
+}
+
+bool SaveState::readBlock(void* dst, size_t length)
+{
+	if(this->position + length > this->size)
+	{
+		return false;
+	}
+	std::memcpy(dst, this->data.data() + this->position, length);
+	this->position += length;
+	return true;
+}
+
+const uint8_t* SaveState::readSpan(size_t length)
+{
+	if(this->position + length > this->size)
+	{
+		return nullptr;
+	}
+	const uint8_t* span = this->data.data() + this->position;
+	this->position += length;
+	return span;
+}
+
+uint8_t* SaveState::getData()
+{
+	return this->data.data();
+}
+
+const uint8_t* SaveState::getData() const
+{
+	return this->data.data();
+}
+
+size_t SaveState::getSize() const
+{
+	return this->size;
+}
+
+size_t SaveState::getCapacity() const
+{
+	return this->data.capacity();
+}
+
+void SaveState::setSize(size_t newSize)
+{
+	if(newSize > this->data.size())
+	{
+		this->data.resize(newSize);
+	}
+	this->size = newSize;
+	this->position = 0;
+}
+
+bool SaveState::saveToFile(std::string path)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if(!file)
+	{
+		return false;
+	}
+	file.write((const char*)this->data.data(), this->size);
+	return file.good();
+}
+
+bool SaveState::loadFromFile(std::string path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if(!file)
+	{
+		return false;
+	}
+	std::streamsize length = file.tellg();
+	if(length <= 0)
+	{
+		return false;
+	}
+	file.seekg(0, std::ios::beg);
+	this->setSize((size_t)length);
+	file.read((char*)this->data.data(), length);
+	return file.good();
+}
+
+/*
+<++> SaveState::<++>()
+{
+
+}
+*/
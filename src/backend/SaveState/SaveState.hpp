@@ -0,0 +1,88 @@
+/*==================================================================================
+ *Class - SaveState
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Flat serialized machine state. Components append their state in a fixed order, so two states of the same rom are always the same size.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#define SAVE_STATE_MAGIC 0x54534247 //"GBST"
+#define SAVE_STATE_VERSION 7
+
+class SaveState
+{
+	//Attributes
+public:
+
+private:
+	//backing buffer only ever grows, so re-capturing into the same SaveState does not allocate.
+	std::vector<uint8_t> data;
+	size_t size = 0;
+	size_t position = 0;
+	//Methods
+public:
+	SaveState();
+	~SaveState();
+
+	//Start a new capture, keeps the backing buffer.
+	void clear();
+	//Move the read cursor back to the start of the state.
+	void rewind();
+
+	void writeBlock(const void* src, size_t length);
+	bool readBlock(void* dst, size_t length);
+	//The next length bytes in place, for readers that compare before copying. nullptr if the state is too short.
+	const uint8_t* readSpan(size_t length);
+
+	template<typename T>
+	void write(const T& value)
+	{
+		this->writeBlock(&value, sizeof(T));
+	}
+	template<typename T>
+	bool read(T& value)
+	{
+		return this->readBlock(&value, sizeof(T));
+	}
+
+	uint8_t* getData();
+	const uint8_t* getData() const;
+	size_t getSize() const;
+	size_t getCapacity() const;
+	//Resizes the state without touching its contents, used when copying raw state bytes in.
+	void setSize(size_t newSize);
+
+	bool saveToFile(std::string path);
+	bool loadFromFile(std::string path);
+private:
+};
@@ -0,0 +1,108 @@
+/*==================================================================================
+ *Class - StartStateCache
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Process wide cache of each rom's start state (post boot, or a point the user chose), keyed by rom hash. Resets copy it instead of booting again.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "StartStateCache.hpp"
+
+namespace
+{
+	//Entries are immutable once stored, a lookup only holds the lock long enough to take a reference.
+	std::mutex cacheLock;
+	std::map<uint64_t, std::shared_ptr<const std::vector<uint8_t>>> cache;
+}
+
+bool StartStateCache::lookup(uint64_t key, SaveState* out)
+{
+	std::shared_ptr<const std::vector<uint8_t>> entry;
+	{
+		std::lock_guard<std::mutex> guard(cacheLock);
+		auto found = cache.find(key);
+		if(found == cache.end())
+		{
+			return false;
+		}
+		entry = found->second;
+	}
+	out->setSize(entry->size());
+	std::memcpy(out->getData(), entry->data(), entry->size());
+	out->rewind();
+	return true;
+}
+
+void StartStateCache::store(uint64_t key, SaveState* state)
+{
+	std::shared_ptr<const std::vector<uint8_t>> entry = std::make_shared<const std::vector<uint8_t>>(state->getData(), state->getData() + state->getSize());
+	std::lock_guard<std::mutex> guard(cacheLock);
+	cache[key] = entry;
+}
+
+void StartStateCache::remove(uint64_t key)
+{
+	std::lock_guard<std::mutex> guard(cacheLock);
+	cache.erase(key);
+}
+
+void StartStateCache::clear()
+{
+	std::lock_guard<std::mutex> guard(cacheLock);
+	cache.clear();
+}
+
+size_t StartStateCache::getCount()
+{
+	std::lock_guard<std::mutex> guard(cacheLock);
+	return cache.size();
+}
+
+StartStateCache::StartStateCache()
+{
+
+}
+
+StartStateCache::~StartStateCache()
+{
+
+}
+
+/*
+<++> StartStateCache::<++>()
+{
+
+}
+*/
@@ -0,0 +1,58 @@
+/*==================================================================================
+ *Class - StartStateCache
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Process wide cache of each rom's start state (post boot, or a point the user chose), keyed by rom hash. Resets copy it instead of booting again.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "../SaveState/SaveState.hpp"
+
+class StartStateCache
+{
+	//Attributes
+public:
+
+private:
+	//Methods
+public:
+	//Copies the cached state for key into out. Reuses out's buffer, so a warm instance does not allocate.
+	static bool lookup(uint64_t key, SaveState* out);
+	//Replaces any state already cached under key.
+	static void store(uint64_t key, SaveState* state);
+	static void remove(uint64_t key);
+	static void clear();
+	static size_t getCount();
+private:
+	StartStateCache();
+	~StartStateCache();
+};
@@ -0,0 +1,247 @@
+/*==================================================================================
+ *Class - StateHash
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Fast 64-bit fingerprint of memory blocks. Stripe accumulator in the style of xxHash3, with SSE2 and AVX2 paths that give the same result as the scalar one.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include "StateHash.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define STATE_HASH_X86 1
+#endif
+
+#define PRIME32_1 0x9E3779B1U
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+//Per lane keys. A stripe uses lanes [keyOffset, keyOffset + 8) so neighbouring stripes see different keys.
+static const uint64_t stateHashKeys[STATE_HASH_LANES + STATE_HASH_STRIPES_PER_BLOCK] = {
+	0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+	0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL, 0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL,
+	0xcb00c391bb52283cULL, 0xa32e531b8b65d088ULL, 0x4ef90da297486471ULL, 0xd8acdea946ef1938ULL,
+	0x3f349ce33f76faa8ULL, 0x1d4f0bc7c7bbdcf9ULL, 0x3159b4cd4be0518aULL, 0x647378d9c97e9fc8ULL,
+	0xc3ebd33483acc5eaULL, 0xeb6313faffa081c5ULL, 0x49daf0b751dd0d17ULL, 0x9e68d429265516d3ULL,
+	0xfca1477d58be162bULL, 0xce31d07ad1b8f88fULL, 0x280416958f3acb45ULL, 0x7e404bbbcafbd7afULL
+};
+
+#if defined(STATE_HASH_X86)
+static bool stateHashHasAvx2()
+{
+	static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+	return hasAvx2;
+}
+#endif
+
+uint64_t StateHash::hash(const uint8_t* data, size_t length, uint64_t seed)
+{
+	if(length <= STATE_HASH_STRIPE)
+	{
+		return hashShort(data, length, seed);
+	}
+	uint64_t acc[STATE_HASH_LANES] = {
+		PRIME32_1, PRIME64_1, PRIME64_2, PRIME64_3,
+		PRIME64_4, PRIME32_1, PRIME64_5, PRIME64_1
+	};
+	for(int i = 0; i < STATE_HASH_LANES; i++)
+	{
+		acc[i] ^= seed;
+	}
+	size_t stripes = (length - 1) / STATE_HASH_STRIPE;
+	size_t stripe = 0;
+	//Whole blocks, then the stripes left over, then the last 64 bytes (overlapping) so the tail needs no padding.
+	while(stripe < stripes)
+	{
+		size_t count = stripes - stripe;
+		if(count > STATE_HASH_STRIPES_PER_BLOCK)
+		{
+			count = STATE_HASH_STRIPES_PER_BLOCK;
+		}
+		const uint8_t* block = data + stripe * STATE_HASH_STRIPE;
+#if defined(STATE_HASH_X86)
+		if(stateHashHasAvx2())
+		{
+			accumulateAvx2(acc, block, count, 0);
+		}
+		else
+		{
+			accumulateSse2(acc, block, count, 0);
+		}
+#else
+		accumulateScalar(acc, block, count, 0);
+#endif
+		stripe += count;
+		if(count == STATE_HASH_STRIPES_PER_BLOCK)
+		{
+			scramble(acc);
+		}
+	}
+	accumulateScalar(acc, data + length - STATE_HASH_STRIPE, 1, 7);
+
+	uint64_t result = length * PRIME64_1 ^ seed;
+	for(int i = 0; i < STATE_HASH_LANES; i += 2)
+	{
+		result += mulFold(acc[i] ^ stateHashKeys[i + 11], acc[i + 1] ^ stateHashKeys[i + 12]);
+	}
+	return avalanche(result);
+}
+
+uint64_t StateHash::hashShort(const uint8_t* data, size_t length, uint64_t seed)
+{
+	uint64_t h = seed ^ (length * PRIME64_5);
+	size_t i = 0;
+	for(; i + 8 <= length; i += 8)
+	{
+		h = mulFold(h ^ read64(data + i) ^ stateHashKeys[(i >> 3) & 7], PRIME64_2 ^ stateHashKeys[8 + ((i >> 3) & 7)]);
+	}
+	if(i < length)
+	{
+		uint8_t tail[8] = {0};
+		std::memcpy(tail, data + i, length - i);
+		h = mulFold(h ^ read64(tail) ^ stateHashKeys[9], PRIME64_3);
+	}
+	return avalanche(h);
+}
+
+void StateHash::accumulateScalar(uint64_t* acc, const uint8_t* data, size_t stripes, size_t keyOffset)
+{
+	for(size_t s = 0; s < stripes; s++)
+	{
+		const uint8_t* stripe = data + s * STATE_HASH_STRIPE;
+		const uint64_t* keys = stateHashKeys + ((s + keyOffset) & (STATE_HASH_STRIPES_PER_BLOCK - 1));
+		for(int i = 0; i < STATE_HASH_LANES; i++)
+		{
+			uint64_t value = read64(stripe + i * 8);
+			uint64_t key = value ^ keys[i];
+			acc[i ^ 1] += value;
+			acc[i] += (key & 0xFFFFFFFFULL) * (key >> 32);
+		}
+	}
+}
+
+#if defined(STATE_HASH_X86)
+void StateHash::accumulateSse2(uint64_t* acc, const uint8_t* data, size_t stripes, size_t keyOffset)
+{
+	__m128i* accVec = (__m128i*)acc;
+	for(size_t s = 0; s < stripes; s++)
+	{
+		const __m128i* stripe = (const __m128i*)(data + s * STATE_HASH_STRIPE);
+		const __m128i* keys = (const __m128i*)(stateHashKeys + ((s + keyOffset) & (STATE_HASH_STRIPES_PER_BLOCK - 1)));
+		for(int i = 0; i < STATE_HASH_LANES / 2; i++)
+		{
+			__m128i value = _mm_loadu_si128(stripe + i);
+			__m128i key = _mm_xor_si128(value, _mm_loadu_si128(keys + i));
+			__m128i keyHigh = _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1));
+			__m128i product = _mm_mul_epu32(key, keyHigh);
+			__m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+			__m128i sum = _mm_add_epi64(_mm_loadu_si128(accVec + i), swapped);
+			_mm_storeu_si128(accVec + i, _mm_add_epi64(sum, product));
+		}
+	}
+}
+
+__attribute__((target("avx2")))
+void StateHash::accumulateAvx2(uint64_t* acc, const uint8_t* data, size_t stripes, size_t keyOffset)
+{
+	__m256i accLow = _mm256_loadu_si256((const __m256i*)acc);
+	__m256i accHigh = _mm256_loadu_si256((const __m256i*)(acc + 4));
+	for(size_t s = 0; s < stripes; s++)
+	{
+		const uint8_t* stripe = data + s * STATE_HASH_STRIPE;
+		const uint64_t* keys = stateHashKeys + ((s + keyOffset) & (STATE_HASH_STRIPES_PER_BLOCK - 1));
+		__m256i valueLow = _mm256_loadu_si256((const __m256i*)stripe);
+		__m256i valueHigh = _mm256_loadu_si256((const __m256i*)(stripe + 32));
+		__m256i keyLow = _mm256_xor_si256(valueLow, _mm256_loadu_si256((const __m256i*)keys));
+		__m256i keyHigh = _mm256_xor_si256(valueHigh, _mm256_loadu_si256((const __m256i*)(keys + 4)));
+		__m256i productLow = _mm256_mul_epu32(keyLow, _mm256_shuffle_epi32(keyLow, _MM_SHUFFLE(0, 3, 0, 1)));
+		__m256i productHigh = _mm256_mul_epu32(keyHigh, _mm256_shuffle_epi32(keyHigh, _MM_SHUFFLE(0, 3, 0, 1)));
+		accLow = _mm256_add_epi64(accLow, _mm256_shuffle_epi32(valueLow, _MM_SHUFFLE(1, 0, 3, 2)));
+		accHigh = _mm256_add_epi64(accHigh, _mm256_shuffle_epi32(valueHigh, _MM_SHUFFLE(1, 0, 3, 2)));
+		accLow = _mm256_add_epi64(accLow, productLow);
+		accHigh = _mm256_add_epi64(accHigh, productHigh);
+	}
+	_mm256_storeu_si256((__m256i*)acc, accLow);
+	_mm256_storeu_si256((__m256i*)(acc + 4), accHigh);
+}
+#else
+void StateHash::accumulateSse2(uint64_t* acc, const uint8_t* data, size_t stripes, size_t keyOffset)
+{
+	accumulateScalar(acc, data, stripes, keyOffset);
+}
+
+void StateHash::accumulateAvx2(uint64_t* acc, const uint8_t* data, size_t stripes, size_t keyOffset)
+{
+	accumulateScalar(acc, data, stripes, keyOffset);
+}
+#endif
+
+void StateHash::scramble(uint64_t* acc)
+{
+	for(int i = 0; i < STATE_HASH_LANES; i++)
+	{
+		uint64_t value = acc[i];
+		value ^= value >> 47;
+		value ^= stateHashKeys[STATE_HASH_STRIPES_PER_BLOCK + i];
+		acc[i] = value * PRIME32_1;
+	}
+}
+
+uint64_t StateHash::avalanche(uint64_t h)
+{
+	h ^= h >> 37;
+	h *= 0x165667919E3779F9ULL;
+	h ^= h >> 32;
+	return h;
+}
+
+uint64_t StateHash::mulFold(uint64_t a, uint64_t b)
+{
+	__uint128_t product = (__uint128_t)a * b;
+	return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+uint64_t StateHash::read64(const uint8_t* p)
+{
+	uint64_t value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+/*
+<++> StateHash::<++>()
+{
+
+}
+*/
@@ -0,0 +1,61 @@
+/*==================================================================================
+ *Class - StateHash
+ *Author - Zach Walden
+ *Created - 10/19/26
+ *Last Changed - 10/19/26
+ *Description - Fast 64-bit fingerprint of memory blocks. Stripe accumulator in the style of xxHash3, with SSE2 and AVX2 paths that give the same result as the scalar one.
+====================================================================================*/
+
+/*
+ * This program source code file is part of PROJECT_NAME
+ *
+ * Copyright (C) 2022 Zachary Walden zachary.walden@eagles.oc.edu
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/lgpl-3.0.en.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#define STATE_HASH_STRIPE 64
+#define STATE_HASH_LANES 8
+//Accumulators are scrambled once per block of stripes, 1KB.
+#define STATE_HASH_STRIPES_PER_BLOCK 16
+
+class StateHash
+{
+	//Attributes
+public:
+
+private:
+	//Methods
+public:
+	//Chain blocks by passing the previous hash as the seed.
+	static uint64_t hash(const uint8_t* data, size_t length, uint64_t seed);
+private:
+	static uint64_t hashShort(const uint8_t* data, size_t length, uint64_t seed);
+	static void accumulateScalar(uint64_t* acc, const uint8_t* data, size_t stripes, size_t keyOffset);
+	static void accumulateSse2(uint64_t* acc, const uint8_t* data, size_t stripes, size_t keyOffset);
+	static void accumulateAvx2(uint64_t* acc, const uint8_t* data, size_t stripes, size_t keyOffset);
+	static void scramble(uint64_t* acc);
+	static uint64_t avalanche(uint64_t h);
+	static uint64_t mulFold(uint64_t a, uint64_t b);
+	static uint64_t read64(const uint8_t* p);
+};